@@ -27,7 +27,9 @@ extern PFN_vkEnumerateInstanceLayerProperties vkEnumerateInstanceLayerProperties
 extern PFN_vkEnumeratePhysicalDevices vkEnumeratePhysicalDevices;
 extern PFN_vkGetInstanceProcAddr vkGetInstanceProcAddr;
 extern PFN_vkGetPhysicalDeviceFeatures vkGetPhysicalDeviceFeatures;
+extern PFN_vkGetPhysicalDeviceFeatures2 vkGetPhysicalDeviceFeatures2;
 extern PFN_vkGetPhysicalDeviceFormatProperties vkGetPhysicalDeviceFormatProperties;
+extern PFN_vkGetPhysicalDeviceFormatProperties2 vkGetPhysicalDeviceFormatProperties2;
 extern PFN_vkGetPhysicalDeviceMemoryProperties vkGetPhysicalDeviceMemoryProperties;
 extern PFN_vkGetPhysicalDeviceMemoryProperties2 vkGetPhysicalDeviceMemoryProperties2;
 extern PFN_vkGetPhysicalDeviceProperties vkGetPhysicalDeviceProperties;
@@ -72,7 +74,9 @@ extern PFN_vkCmdDrawIndexedIndirect vkCmdDrawIndexedIndirect;
 extern PFN_vkCmdDrawIndexedIndirectCount vkCmdDrawIndexedIndirectCount;
 extern PFN_vkCmdFillBuffer vkCmdFillBuffer;
 extern PFN_vkCmdEndRendering vkCmdEndRendering;
+extern PFN_vkCmdExecuteCommands vkCmdExecuteCommands;
 extern PFN_vkCmdPipelineBarrier vkCmdPipelineBarrier;
+extern PFN_vkCmdPipelineBarrier2 vkCmdPipelineBarrier2;
 extern PFN_vkCmdSetDepthBias vkCmdSetDepthBias;
 extern PFN_vkCmdSetStencilReference vkCmdSetStencilReference;
 extern PFN_vkCmdSetRasterizerDiscardEnable vkCmdSetRasterizerDiscardEnable;
@@ -119,6 +123,7 @@ extern PFN_vkGetDeviceImageMemoryRequirements vkGetDeviceImageMemoryRequirements
 extern PFN_vkGetDeviceQueue vkGetDeviceQueue;
 extern PFN_vkGetImageMemoryRequirements vkGetImageMemoryRequirements;
 extern PFN_vkGetImageMemoryRequirements2 vkGetImageMemoryRequirements2;
+extern PFN_vkGetSemaphoreCounterValue vkGetSemaphoreCounterValue;
 extern PFN_vkCmdPushConstants vkCmdPushConstants;
 extern PFN_vkQueueSubmit vkQueueSubmit;
 extern PFN_vkQueueSubmit2 vkQueueSubmit2;
@@ -146,6 +151,7 @@ extern PFN_vkMapMemory vkMapMemory;
 extern PFN_vkUnmapMemory vkUnmapMemory;
 extern PFN_vkUpdateDescriptorSets vkUpdateDescriptorSets;
 extern PFN_vkWaitForFences vkWaitForFences;
+extern PFN_vkWaitSemaphores vkWaitSemaphores;
 
 /*
  * VK_KHR_swapchain device extension
@@ -156,6 +162,17 @@ extern PFN_vkDestroySwapchainKHR vkDestroySwapchainKHR;
 extern PFN_vkGetSwapchainImagesKHR vkGetSwapchainImagesKHR;
 extern PFN_vkQueuePresentKHR vkQueuePresentKHR;
 
+/*
+ * VK_EXT_external_memory_host device extension
+ */
+extern PFN_vkGetMemoryHostPointerPropertiesEXT vkGetMemoryHostPointerPropertiesEXT;
+
+/*
+ * VK_EXT_host_image_copy device extension
+ */
+extern PFN_vkCopyMemoryToImageEXT vkCopyMemoryToImageEXT;
+extern PFN_vkTransitionImageLayoutEXT vkTransitionImageLayoutEXT;
+
 /*
  * VK_EXT_shader_object device extension
  */
@@ -0,0 +1,327 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+module;
+#include <cassert>
+#include <cstring>
+#ifdef __linux__
+#include <cerrno>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+module vireo.files;
+
+import vireo.tools;
+
+namespace vireo {
+
+    AsyncFileReader::AsyncFileReader(const uint32_t queueDepth) {
+        assert(queueDepth > 0);
+#ifdef __linux__
+        if (createRing(queueDepth)) {
+            inFlight.reserve(queueDepth);
+        }
+#endif
+    }
+
+    AsyncFileReader::~AsyncFileReader() {
+        // Unmapping the ring does not cancel the reads, they would write into released memory
+        drain();
+        close();
+#ifdef __linux__
+        destroyRing();
+#endif
+    }
+
+    void AsyncFileReader::open(const std::filesystem::path& file, const bool direct) {
+        close();
+        this->file = file;
+#ifdef __linux__
+        if (ringFd >= 0) {
+            // Some file systems (tmpfs, network file systems) refuse the unbuffered reads
+            if (direct && !directRefused) {
+                fd = ::open(file.c_str(), O_RDONLY | O_DIRECT);
+                this->direct = fd >= 0;
+            }
+            if (fd < 0) {
+                fd = ::open(file.c_str(), O_RDONLY);
+            }
+            if (fd < 0) {
+                throw Exception("Error opening file ", file.string());
+            }
+            return;
+        }
+#endif
+        stream.open(file, std::ios::binary);
+        if (!stream) {
+            throw Exception("Error opening file ", file.string());
+        }
+    }
+
+    void AsyncFileReader::close() {
+        completed.clear();
+        if (stream.is_open()) {
+            stream.close();
+        }
+        direct = false;
+#ifdef __linux__
+        assert(inFlight.empty());
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+        if (bufferedFd >= 0) {
+            ::close(bufferedFd);
+            bufferedFd = -1;
+        }
+#endif
+    }
+
+    void AsyncFileReader::read(const uint64_t userData, void* destination, const size_t offset, const uint32_t size) {
+        assert(!direct || (
+            offset % DIRECT_ALIGNMENT == 0 &&
+            size % DIRECT_ALIGNMENT == 0 &&
+            reinterpret_cast<uintptr_t>(destination) % DIRECT_ALIGNMENT == 0));
+#ifdef __linux__
+        if (ringFd >= 0) {
+            assert(fd >= 0);
+            // Only this thread writes the submission queue tail
+            const auto tail = *sqTail;
+            const auto index = tail & sqMask;
+            auto& sqe = static_cast<io_uring_sqe*>(sqes)[index];
+            sqe = {};
+            sqe.opcode = IORING_OP_READ;
+            sqe.fd = fd;
+            sqe.addr = reinterpret_cast<uint64_t>(destination);
+            sqe.len = size;
+            sqe.off = offset;
+            sqe.user_data = userData;
+            sqArray[index] = index;
+            inFlight.push_back({userData, destination, offset, size});
+            std::atomic_ref(*sqTail).store(tail + 1, std::memory_order_release);
+            pendingSubmits++;
+            return;
+        }
+#endif
+        if (!stream.seekg(offset)) {
+            throw Exception("Error seeking file ", file.string());
+        }
+        stream.read(static_cast<char*>(destination), size);
+        completed.push_back({userData, static_cast<size_t>(stream.gcount())});
+        // Reading past the end of the file is reported by the size of the read
+        stream.clear();
+    }
+
+    void AsyncFileReader::submit() {
+#ifdef __linux__
+        while (pendingSubmits > 0) {
+            const auto submitted = syscall(__NR_io_uring_enter, ringFd, pendingSubmits, 0, 0, nullptr, 0);
+            if (submitted < 0) {
+                if (errno == EINTR) { continue; }
+                throw Exception("Error submitting reads of ", file.string(), " : ", std::strerror(errno));
+            }
+            pendingSubmits -= static_cast<uint32_t>(submitted);
+        }
+#endif
+    }
+
+    std::optional<std::pair<uint64_t, size_t>> AsyncFileReader::poll() {
+#ifdef __linux__
+        if (ringFd >= 0) {
+            submit();
+            auto userData = uint64_t{0};
+            auto result = int32_t{0};
+            if (popCompletion(userData, result)) {
+                return completeRead(userData, result);
+            }
+            return {};
+        }
+#endif
+        if (completed.empty()) { return {}; }
+        const auto result = completed.front();
+        completed.pop_front();
+        return result;
+    }
+
+    std::pair<uint64_t, size_t> AsyncFileReader::wait() {
+#ifdef __linux__
+        if (ringFd >= 0) {
+            while (true) {
+                if (const auto result = poll()) {
+                    return *result;
+                }
+                if (syscall(__NR_io_uring_enter, ringFd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 &&
+                    errno != EINTR) {
+                    throw Exception("Error waiting reads of ", file.string(), " : ", std::strerror(errno));
+                }
+            }
+        }
+#endif
+        const auto result = poll();
+        assert(result.has_value());
+        return *result;
+    }
+
+    void AsyncFileReader::drain() noexcept {
+        completed.clear();
+#ifdef __linux__
+        if (ringFd < 0) { return; }
+        // The kernel only consumes the submission queue in io_uring_enter(), the queued reads can be dropped
+        if (pendingSubmits > 0) {
+            std::atomic_ref(*sqTail).store(*sqTail - pendingSubmits, std::memory_order_release);
+            inFlight.resize(inFlight.size() - pendingSubmits);
+            pendingSubmits = 0;
+        }
+        while (!inFlight.empty()) {
+            auto userData = uint64_t{0};
+            auto result = int32_t{0};
+            if (popCompletion(userData, result)) {
+                std::erase_if(inFlight, [userData](const InFlightRead& read) { return read.userData == userData; });
+                continue;
+            }
+            if (syscall(__NR_io_uring_enter, ringFd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 &&
+                errno != EINTR) {
+                // The ring is unusable, nothing else can be done but leaking the memory of the reads
+                assert(false);
+                inFlight.clear();
+            }
+        }
+#endif
+    }
+
+#ifdef __linux__
+    bool AsyncFileReader::createRing(const uint32_t entries) {
+        auto params = io_uring_params{};
+        ringFd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        // Kernel without io_uring or io_uring disabled by the system
+        if (ringFd < 0) { return false; }
+        // IORING_OP_READ came with the same kernel version (5.6) as IORING_FEAT_RW_CUR_POS
+        if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+            destroyRing();
+            return false;
+        }
+
+        const auto singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        if (singleMap) {
+            sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+        }
+        sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+        if (sqRing == MAP_FAILED) {
+            sqRing = nullptr;
+            destroyRing();
+            return false;
+        }
+        if (singleMap) {
+            cqRing = sqRing;
+        } else {
+            cqRing = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+            if (cqRing == MAP_FAILED) {
+                cqRing = nullptr;
+                destroyRing();
+                return false;
+            }
+        }
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            sqes = nullptr;
+            destroyRing();
+            return false;
+        }
+
+        auto* sq = static_cast<char*>(sqRing);
+        sqTail = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+        sqMask = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+        auto* cq = static_cast<char*>(cqRing);
+        cqHead = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+        cqMask = *reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+        cqes = cq + params.cq_off.cqes;
+        return true;
+    }
+
+    void AsyncFileReader::destroyRing() {
+        if (sqes) {
+            munmap(sqes, sqesSize);
+            sqes = nullptr;
+        }
+        if (cqRing && cqRing != sqRing) {
+            munmap(cqRing, cqRingSize);
+        }
+        cqRing = nullptr;
+        if (sqRing) {
+            munmap(sqRing, sqRingSize);
+            sqRing = nullptr;
+        }
+        if (ringFd >= 0) {
+            ::close(ringFd);
+            ringFd = -1;
+        }
+    }
+
+    bool AsyncFileReader::popCompletion(uint64_t& userData, int32_t& result) {
+        // Only this thread writes the completion queue head
+        const auto head = *cqHead;
+        if (head == std::atomic_ref(*cqTail).load(std::memory_order_acquire)) {
+            return false;
+        }
+        const auto& cqe = static_cast<const io_uring_cqe*>(cqes)[head & cqMask];
+        userData = cqe.user_data;
+        result = cqe.res;
+        std::atomic_ref(*cqHead).store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::pair<uint64_t, size_t> AsyncFileReader::completeRead(const uint64_t userData, const int32_t result) {
+        const auto it = std::ranges::find(inFlight, userData, &InFlightRead::userData);
+        assert(it != inFlight.end());
+        const auto read = *it;
+        inFlight.erase(it);
+        auto size = static_cast<int64_t>(result);
+        // get_user_pages() fails on some mappings of device memory (-EFAULT) and some file systems
+        // refuse the unbuffered reads with -EINVAL, read the range again through the page cache.
+        // This read blocks, but only until the next files are opened without O_DIRECT
+        if (direct && (result == -EFAULT || result == -EINVAL)) {
+            directRefused = true;
+            size = readBuffered(read);
+        }
+        if (size < 0) {
+            throw Exception("Error reading file ", file.string(), " : ", std::strerror(static_cast<int>(-size)));
+        }
+        return {userData, static_cast<size_t>(size)};
+    }
+
+    int64_t AsyncFileReader::readBuffered(const InFlightRead& read) {
+        if (bufferedFd < 0) {
+            bufferedFd = ::open(file.c_str(), O_RDONLY);
+            if (bufferedFd < 0) { return -errno; }
+        }
+        auto total = size_t{0};
+        while (total < read.size) {
+            const auto bytes = pread(
+                bufferedFd,
+                static_cast<char*>(read.destination) + total,
+                read.size - total,
+                static_cast<off_t>(read.offset + total));
+            if (bytes < 0) {
+                if (errno == EINTR) { continue; }
+                return -errno;
+            }
+            // End of file
+            if (bytes == 0) { break; }
+            total += static_cast<size_t>(bytes);
+        }
+        return static_cast<int64_t>(total);
+    }
+#endif
+
+}
@@ -0,0 +1,111 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+export module vireo.files;
+
+import std;
+
+export namespace vireo {
+
+    // Reads ranges of files asynchronously into caller owned memory.
+    // On Linux the reads are queued in an io_uring and, when possible, bypass the page cache (O_DIRECT).
+    // Elsewhere, or when io_uring is not available, the reads are done synchronously when queued.
+    // The ring is created once and reused for all the files read.
+    class AsyncFileReader {
+    public:
+        // Offsets, sizes and addresses alignment required by the unbuffered reads
+        static constexpr size_t DIRECT_ALIGNMENT{4096};
+
+        // Creates the queue for at most queueDepth reads in flight
+        explicit AsyncFileReader(uint32_t queueDepth);
+
+        // Waits for the reads still in flight, the kernel writes their destination until they complete
+        ~AsyncFileReader();
+
+        // Opens the file of the next reads, closing the previous one, no read must be in flight.
+        // Unbuffered reads are only requested if `direct` is `true`.
+        void open(const std::filesystem::path& file, bool direct);
+
+        // Closes the file, no read must be in flight
+        void close();
+
+        // Returns true if the reads bypass the page cache and must be aligned on DIRECT_ALIGNMENT
+        auto isDirect() const { return direct; }
+
+        // Queues the read of a range of the file, the memory must stay valid until the completion of the read
+        void read(uint64_t userData, void* destination, size_t offset, uint32_t size);
+
+        // Starts the queued reads
+        void submit();
+
+        // Returns the user data and the number of bytes read of a completed read, or nothing without blocking
+        // if no read is completed
+        std::optional<std::pair<uint64_t, size_t>> poll();
+
+        // Waits for a read to complete and returns its user data and the number of bytes read
+        std::pair<uint64_t, size_t> wait();
+
+        // Waits for all the reads in flight and drops their results, the queued reads are never started.
+        // Must be called before releasing the memory of the reads when a load is interrupted.
+        void drain() noexcept;
+
+        AsyncFileReader(AsyncFileReader&) = delete;
+        AsyncFileReader& operator=(AsyncFileReader&) = delete;
+
+    private:
+        struct InFlightRead {
+            uint64_t userData;
+            void*    destination;
+            size_t   offset;
+            uint32_t size;
+        };
+
+        std::filesystem::path file;
+        bool                  direct{false};
+        // Completed synchronous reads
+        std::deque<std::pair<uint64_t, size_t>> completed;
+        std::ifstream         stream;
+#ifdef __linux__
+        int       fd{-1};
+        // Buffered descriptor of the file, used when an unbuffered read is refused
+        int       bufferedFd{-1};
+        // Unbuffered reads are refused for some memory (mappings of device memory), stop requesting them
+        bool      directRefused{false};
+        int       ringFd{-1};
+        void*     sqRing{nullptr};
+        size_t    sqRingSize{0};
+        void*     cqRing{nullptr};
+        size_t    cqRingSize{0};
+        void*     sqes{nullptr};
+        size_t    sqesSize{0};
+        uint32_t* sqTail{nullptr};
+        uint32_t  sqMask{0};
+        uint32_t* sqArray{nullptr};
+        uint32_t* cqHead{nullptr};
+        uint32_t* cqTail{nullptr};
+        uint32_t  cqMask{0};
+        void*     cqes{nullptr};
+        // Number of reads queued since the last submission
+        uint32_t  pendingSubmits{0};
+        // Reads queued or submitted and not completed yet, in queue order
+        std::vector<InFlightRead> inFlight;
+
+        bool createRing(uint32_t entries);
+
+        void destroyRing();
+
+        // Pops a completion, returns false if none is available
+        bool popCompletion(uint64_t& userData, int32_t& result);
+
+        // Reads a range again through the page cache, returns the number of bytes read or -errno
+        int64_t readBuffered(const InFlightRead& read);
+
+        // Forgets a completed read and returns its user data and the number of bytes read
+        std::pair<uint64_t, size_t> completeRead(uint64_t userData, int32_t result);
+#endif
+    };
+
+}
@@ -10,6 +10,7 @@ module;
 module vireo;
 
 import std;
+import vireo.files;
 import vireo.tools;
 import vireo.vulkan;
 #ifdef DIRECTX_BACKEND
@@ -18,11 +19,75 @@ import vireo.directx;
 
 namespace vireo {
 
-    std::mutex Buffer::memoryAllocationsMutex;
-    std::list<VideoMemoryAllocationDesc> Buffer::memoryAllocations{};
+    std::array<Buffer::MemoryUsageCounters, Buffer::BUFFER_TYPE_COUNT> Buffer::memoryUsage{};
 
-    std::mutex Image::memoryAllocationsMutex;
-    std::list<VideoMemoryAllocationDesc> Image::memoryAllocations{};
+    std::atomic<uint32_t> Image::memoryUsageCount{0};
+    std::atomic<size_t> Image::memoryUsageSize{0};
+
+    void Buffer::trackMemoryUsage(const size_t size) {
+        if constexpr (isMemoryUsageEnabled()) {
+            assert(trackedSize == 0);
+            trackedSize = size;
+            auto& counters = memoryUsage[static_cast<size_t>(type)];
+            counters.count.fetch_add(1, std::memory_order_relaxed);
+            counters.size.fetch_add(size, std::memory_order_relaxed);
+        }
+    }
+
+    size_t Buffer::detachMemoryUsage() {
+        return std::exchange(trackedSize, 0);
+    }
+
+    void Buffer::untrackMemoryUsage(const BufferType type, const size_t size) {
+        if (size > 0) {
+            auto& counters = memoryUsage[static_cast<size_t>(type)];
+            counters.count.fetch_sub(1, std::memory_order_relaxed);
+            counters.size.fetch_sub(size, std::memory_order_relaxed);
+        }
+    }
+
+    Buffer::~Buffer() {
+        untrackMemoryUsage(type, trackedSize);
+    }
+
+    VideoMemoryUsage Buffer::getMemoryUsage(const BufferType type) {
+        const auto& counters = memoryUsage[static_cast<size_t>(type)];
+        return {
+            counters.count.load(std::memory_order_relaxed),
+            counters.size.load(std::memory_order_relaxed),
+        };
+    }
+
+    void Image::trackMemoryUsage(const size_t size) {
+        if constexpr (isMemoryUsageEnabled()) {
+            assert(trackedSize == 0);
+            trackedSize = size;
+            memoryUsageCount.fetch_add(1, std::memory_order_relaxed);
+            memoryUsageSize.fetch_add(size, std::memory_order_relaxed);
+        }
+    }
+
+    size_t Image::detachMemoryUsage() {
+        return std::exchange(trackedSize, 0);
+    }
+
+    void Image::untrackMemoryUsage(const size_t size) {
+        if (size > 0) {
+            memoryUsageCount.fetch_sub(1, std::memory_order_relaxed);
+            memoryUsageSize.fetch_sub(size, std::memory_order_relaxed);
+        }
+    }
+
+    Image::~Image() {
+        untrackMemoryUsage(trackedSize);
+    }
+
+    VideoMemoryUsage Image::getMemoryUsage() {
+        return {
+            memoryUsageCount.load(std::memory_order_relaxed),
+            memoryUsageSize.load(std::memory_order_relaxed),
+        };
+    }
 
     std::shared_ptr<Vireo> Vireo::create(
         const Backend backend,
@@ -44,6 +109,14 @@ namespace vireo {
         return backend == Backend::VULKAN;
     }
 
+    void Vireo::upload(const Image&, const void*, uint32_t) const {
+        throw Exception("Host image copies not supported");
+    }
+
+    std::shared_ptr<Buffer> Vireo::importHostBuffer(void*, size_t, BufferType, const std::wstring&) const {
+        throw Exception("Host memory import not supported");
+    }
+
     std::shared_ptr<DescriptorLayout> Vireo::createDynamicUniformDescriptorLayout(
             const std::wstring& name) const {
         const auto layout = _createDynamicUniformDescriptorLayout(name);
@@ -60,9 +133,9 @@ namespace vireo {
                type == BufferType::IMAGE_UPLOAD ||
                type == BufferType::BUFFER_UPLOAD);
         if (size == WHOLE_SIZE) {
-            for (int y = 0; y < instanceCount; y++) {
-                auto *pScan = static_cast<uint8_t*>(mappedAddress) + y * instanceSizeAligned;
-                auto *pSource = static_cast<const uint8_t*>(data) + y * instanceSize;
+            for (uint32_t y = 0; y < instanceCount; y++) {
+                auto *pScan = static_cast<uint8_t*>(mappedAddress) + size_t{y} * instanceSizeAligned;
+                auto *pSource = static_cast<const uint8_t*>(data) + size_t{y} * instanceSize;
                 memcpy(pScan, pSource, instanceSize);
             }
         } else {
@@ -71,6 +144,13 @@ namespace vireo {
         }
     }
 
+    void Buffer::discard() {
+        assert(mappedAddress != nullptr);
+        const auto baseAddress = static_cast<std::byte*>(mappedAddress) - getCurrentOffset();
+        currentVersion = (currentVersion + 1) % versionCount;
+        mappedAddress = baseAddress + getCurrentOffset();
+    }
+
     void CommandList::upload(const std::vector<BufferUploadInfo>& infos) {
         for (const auto &info : infos) {
             upload(info.buffer, info.data);
@@ -83,6 +163,532 @@ namespace vireo {
         }
     }
 
+    std::vector<BufferInstanceRange> CommandList::mergeInstanceRanges(const std::vector<BufferInstanceRange>& ranges) {
+        auto sorted = ranges;
+        std::ranges::sort(sorted, {}, &BufferInstanceRange::firstInstance);
+        auto merged = std::vector<BufferInstanceRange>{};
+        for (const auto& range : sorted) {
+            if (range.instanceCount == 0) { continue; }
+            if (!merged.empty() &&
+                range.firstInstance <= merged.back().firstInstance + merged.back().instanceCount) {
+                const auto last = std::max(
+                    merged.back().firstInstance + merged.back().instanceCount,
+                    range.firstInstance + range.instanceCount);
+                merged.back().instanceCount = last - merged.back().firstInstance;
+            } else {
+                merged.push_back(range);
+            }
+        }
+        return merged;
+    }
+
+    Readback::Readback(
+        ReadbackRing& ring,
+        const uint64_t id,
+        const size_t offset,
+        const size_t size,
+        const uint64_t value) :
+        ring{ring},
+        id{id},
+        offset{offset},
+        size{size},
+        value{value} {}
+
+    Readback::~Readback() {
+        ring.release(id);
+    }
+
+    bool Readback::isReady() const {
+        return ring.semaphore->getCompletedValue() >= value;
+    }
+
+    void Readback::wait() const {
+        if (!isReady()) {
+            ring.semaphore->wait(value);
+        }
+    }
+
+    const void* Readback::getData() const {
+        assert(isReady());
+        ring.buffer->invalidate(offset, size);
+        return static_cast<const std::byte*>(ring.buffer->getMappedAddress()) + offset;
+    }
+
+    ReadbackRing::ReadbackRing(const std::shared_ptr<Buffer>& buffer, const std::shared_ptr<Semaphore>& semaphore) :
+        buffer{buffer},
+        semaphore{semaphore} {
+        assert(semaphore->getType() == SemaphoreType::TIMELINE);
+        buffer->map();
+    }
+
+    ReadbackRing::~ReadbackRing() {
+        assert(inFlight.empty() || std::ranges::all_of(inFlight, &InFlightRange::released));
+        buffer->unmap();
+    }
+
+    std::shared_ptr<Readback> ReadbackRing::download(
+        const CommandList& commandList,
+        const Buffer& source,
+        const size_t size,
+        const size_t sourceOffset) {
+        const auto copySize = size == Buffer::WHOLE_SIZE ? source.getSize() - sourceOffset : size;
+        assert(sourceOffset + copySize <= source.getSize());
+        auto readback = allocate(copySize);
+        if (readback) {
+            commandList.copy(source, *buffer, copySize, sourceOffset, readback->offset);
+        }
+        return readback;
+    }
+
+    std::shared_ptr<Readback> ReadbackRing::download(
+        const CommandList& commandList,
+        const Image& source,
+        const uint32_t mipLevel) {
+        assert(mipLevel < source.getMipLevels());
+        // Large enough for the aligned rows of DirectX and the packed rows of Vulkan
+        auto readback = allocate(source.getAlignedImageSize(mipLevel) * source.getArraySize());
+        if (readback) {
+            commandList.copy(source, *buffer, readback->offset, mipLevel);
+        }
+        return readback;
+    }
+
+    std::shared_ptr<Readback> ReadbackRing::allocate(const size_t size) {
+        assert(size > 0);
+        auto lock = std::lock_guard(mutex);
+        recycle();
+        if (inFlight.empty()) {
+            head = 0;
+        }
+        const auto ringSize = buffer->getSize();
+        const auto tail = inFlight.empty() ? 0 : inFlight.front().start;
+        const auto alignedHead = (head + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+        std::optional<size_t> offset;
+        if (inFlight.empty() || head > tail) {
+            if (alignedHead + size <= ringSize) {
+                offset = alignedHead;
+            } else if (size < tail) {
+                // Wrap around, the end of the ring is wasted until this range is recycled
+                offset = 0;
+            }
+        } else if (alignedHead + size < tail) {
+            offset = alignedHead;
+        }
+        if (!offset.has_value()) {
+            return nullptr;
+        }
+        // The copy is executed by the next submission signaling the semaphore
+        const auto id = nextId++;
+        const auto value = semaphore->getValue() + 1;
+        inFlight.push_back({ .id = id, .start = head, .value = value });
+        head = *offset + size;
+        return std::shared_ptr<Readback>(new Readback(*this, id, *offset, size, value));
+    }
+
+    void ReadbackRing::release(const uint64_t id) {
+        auto lock = std::lock_guard(mutex);
+        const auto it = std::ranges::find_if(inFlight, [&](const InFlightRange& range) {
+            return range.id == id;
+        });
+        assert(it != inFlight.end());
+        it->released = true;
+        recycle();
+    }
+
+    void ReadbackRing::recycle() {
+        if (inFlight.empty() || !inFlight.front().released) { return; }
+        // A readback dropped before its copy is finished keeps its range until the GPU is done
+        const auto completedValue = semaphore->getCompletedValue();
+        while (!inFlight.empty() && inFlight.front().released && inFlight.front().value <= completedValue) {
+            inFlight.pop_front();
+        }
+    }
+
+    std::shared_ptr<ReadbackRing> Vireo::createReadbackRing(const size_t size, const std::wstring& name) const {
+        return std::make_shared<ReadbackRing>(
+            createBuffer(BufferType::IMAGE_DOWNLOAD, size, 1, name),
+            createSemaphore(SemaphoreType::TIMELINE, name));
+    }
+
+    StreamingLoader::StreamingLoader(
+        const Vireo& vireo,
+        const size_t sliceSize,
+        const uint32_t sliceCount,
+        const std::wstring& name) :
+        sliceSize{sliceSize},
+        reader{std::make_unique<AsyncFileReader>(sliceCount)},
+        transferQueue{vireo.createSubmitQueue(CommandType::TRANSFER, name)},
+        semaphore{vireo.createSemaphore(SemaphoreType::TIMELINE, name)} {
+        assert(sliceSize > 0 && sliceCount > 0);
+        // The file reads take 32 bits sizes
+        assert(sliceSize <= std::numeric_limits<uint32_t>::max());
+        for (uint32_t i = 0; i < sliceCount; i++) {
+            auto slice = Slice {
+                // IMAGE_UPLOAD rows alignment is compatible with the buffers copies
+                .buffer = vireo.createBuffer(BufferType::IMAGE_UPLOAD, sliceSize, 1, name),
+                .commandAllocator = vireo.createCommandAllocator(CommandType::TRANSFER),
+            };
+            slice.commandList = slice.commandAllocator->createCommandList();
+            slice.buffer->map();
+            slices.push_back(slice);
+        }
+        direct =
+            sliceSize % AsyncFileReader::DIRECT_ALIGNMENT == 0 &&
+            std::ranges::all_of(slices, [](const Slice& slice) {
+                return reinterpret_cast<std::uintptr_t>(slice.buffer->getMappedAddress()) %
+                    AsyncFileReader::DIRECT_ALIGNMENT == 0;
+            });
+    }
+
+    StreamingLoader::~StreamingLoader() {
+        // The kernel writes the slices until the reads complete
+        reader->drain();
+        requests.clear();
+        semaphore->wait(semaphore->getValue());
+        for (const auto& slice : slices) {
+            slice.buffer->unmap();
+        }
+    }
+
+    StreamingLoader::FailureGuard::~FailureGuard() {
+        if (std::uncaught_exceptions() > exceptions) {
+            loader.abortRequest();
+        }
+    }
+
+    void StreamingLoader::load(
+        const std::filesystem::path& file,
+        const size_t fileOffset,
+        const size_t size,
+        const Buffer& destination,
+        const size_t destinationOffset) {
+        assert(destinationOffset + size <= destination.getSize());
+        const auto type = destination.getType();
+        if (type != BufferType::VERTEX &&
+            type != BufferType::INDEX &&
+            type != BufferType::INDIRECT &&
+            type != BufferType::DEVICE_STORAGE &&
+            type != BufferType::READWRITE_STORAGE &&
+            !destination.hasUsage(BufferUsage::TRANSFER_DST)) {
+            throw Exception("The streaming destination buffer can't be the destination of a copy");
+        }
+        requests.push_back({
+            .file = file,
+            .fileOffset = fileOffset,
+            .size = size,
+            .buffer = &destination,
+            .destinationOffset = destinationOffset,
+        });
+        poll();
+    }
+
+    void StreamingLoader::load(
+        const std::filesystem::path& file,
+        const size_t fileOffset,
+        const Image& destination,
+        const uint32_t mipLevel,
+        const uint32_t arrayLayer) {
+        assert(mipLevel < destination.getMipLevels());
+        assert(arrayLayer < destination.getArraySize());
+        const auto level = ImageRegion {
+            .width = std::max(1u, destination.getWidth() >> mipLevel),
+            .height = std::max(1u, destination.getHeight() >> mipLevel),
+            .mipLevel = mipLevel,
+            .arrayLayer = arrayLayer,
+        };
+        const auto alignedRowPitch = destination.getAlignedRowPitch(level);
+        const auto rowCount = destination.getRowCount(level);
+        // Large levels are split in bands of rows fitting in a slice
+        const auto sliceRowCount = static_cast<uint32_t>(std::min(
+            sliceSize / alignedRowPitch,
+            size_t{rowCount}));
+        if (sliceRowCount == 0) {
+            throw Exception("Image row larger than the streaming slices");
+        }
+        requests.push_back({
+            .file = file,
+            .fileOffset = fileOffset,
+            .size = rowCount,
+            .image = &destination,
+            .level = level,
+            .rowPitch = destination.getRowPitch(level),
+            .alignedRowPitch = alignedRowPitch,
+            .blockHeight = destination.getFormat() >= ImageFormat::BC1_UNORM ? 4u : 1u,
+            .sliceRowCount = sliceRowCount,
+        });
+        poll();
+    }
+
+    bool StreamingLoader::poll() {
+        const auto failureGuard = FailureGuard{*this};
+        while (!requests.empty()) {
+            const auto& request = requests.front();
+            // Copy the chunks already read while the other reads and copies are in flight
+            while (readCount > 0) {
+                const auto completion = reader->poll();
+                if (!completion) { break; }
+                copyChunk(static_cast<uint32_t>(completion->first), completion->second);
+            }
+            if (copied == request.size) {
+                if (opened) {
+                    reader->close();
+                    opened = false;
+                }
+                requested = 0;
+                copied = 0;
+                requests.pop_front();
+                continue;
+            }
+            if (!opened) {
+                // Unbuffered reads go straight from the disk to the staging memory, the image rows are realigned
+                // after the reads anyway
+                reader->open(request.file, direct && request.buffer);
+                opened = true;
+            }
+            readChunks(request);
+            reader->submit();
+            return false;
+        }
+        return true;
+    }
+
+    void StreamingLoader::readChunks(const Request& request) {
+        // Unbuffered reads start on an aligned file offset, the copies skip the leading bytes
+        const auto alignment = reader->isDirect() ? AsyncFileReader::DIRECT_ALIGNMENT : 1;
+        const auto completedValue = semaphore->getCompletedValue();
+        for (uint32_t index = 0; index < slices.size() && requested < request.size; index++) {
+            auto& slice = slices[index];
+            if (slice.reading || slice.value > completedValue) {
+                continue;
+            }
+            auto* mapped = static_cast<char*>(slice.buffer->getMappedAddress());
+            slice.first = requested;
+            if (request.buffer) {
+                const auto start = request.fileOffset + requested;
+                slice.skew = start % alignment;
+                slice.count = std::min(request.size - requested, sliceSize - slice.skew);
+                const auto readSize = (slice.skew + slice.count + alignment - 1) / alignment * alignment;
+                reader->read(index, mapped, start - slice.skew, static_cast<uint32_t>(readSize));
+            } else {
+                // The packed rows are read at the end of the slice then aligned in place for the copy
+                slice.skew = 0;
+                slice.count = std::min(size_t{request.sliceRowCount}, request.size - requested);
+                const auto bandSize = slice.count * request.rowPitch;
+                reader->read(
+                    index,
+                    mapped + sliceSize - bandSize,
+                    request.fileOffset + requested * request.rowPitch,
+                    static_cast<uint32_t>(bandSize));
+            }
+            slice.reading = true;
+            requested += slice.count;
+            readCount++;
+        }
+    }
+
+    void StreamingLoader::copyChunk(const uint32_t index, const size_t readSize) {
+        const auto& request = requests.front();
+        auto& slice = slices[index];
+        slice.reading = false;
+        readCount--;
+        if (request.buffer) {
+            if (readSize < slice.skew + slice.count) {
+                throw Exception("Error reading file ", request.file.string());
+            }
+            beginSlice(slice);
+            slice.commandList->copy(
+                *slice.buffer,
+                *request.buffer,
+                slice.count,
+                slice.skew,
+                request.destinationOffset + slice.first);
+        } else {
+            const auto bandSize = slice.count * request.rowPitch;
+            if (readSize < bandSize) {
+                throw Exception("Error reading file ", request.file.string());
+            }
+            // Moving the rows in ascending order never overwrites a row not moved yet since the aligned band
+            // fits in the slice
+            auto* mapped = static_cast<char*>(slice.buffer->getMappedAddress());
+            const auto* band = mapped + sliceSize - bandSize;
+            for (size_t y = 0; y < slice.count; y++) {
+                std::memmove(mapped + y * request.alignedRowPitch, band + y * request.rowPitch, request.rowPitch);
+            }
+            auto region = request.level;
+            region.y = static_cast<uint32_t>(slice.first) * request.blockHeight;
+            region.height = std::min(static_cast<uint32_t>(slice.count) * request.blockHeight, region.height - region.y);
+            beginSlice(slice);
+            slice.commandList->copy(*slice.buffer, *request.image, region);
+        }
+        copied += slice.count;
+        if (copied == request.size) {
+            // The submissions of a queue are ordered, the release after the last copy covers all of them
+            if (request.buffer) {
+                slice.commandList->transferOwnership(
+                    *request.buffer, CommandType::TRANSFER, CommandType::GRAPHIC,
+                    request.destinationOffset, request.size);
+                releases.push_back({
+                    .buffer = request.buffer,
+                    .offset = request.destinationOffset,
+                    .size = request.size });
+            } else {
+                slice.commandList->transferOwnership(
+                    *request.image, CommandType::TRANSFER, CommandType::GRAPHIC,
+                    request.level.mipLevel, request.level.arrayLayer);
+                releases.push_back({
+                    .image = request.image,
+                    .mipLevel = request.level.mipLevel,
+                    .arrayLayer = request.level.arrayLayer });
+            }
+        }
+        submitSlice(slice);
+    }
+
+    void StreamingLoader::abortRequest() noexcept {
+        // The kernel writes the slices until the reads complete
+        reader->drain();
+        if (opened) {
+            reader->close();
+            opened = false;
+        }
+        for (auto& slice : slices) {
+            slice.reading = false;
+        }
+        readCount = 0;
+        requested = 0;
+        copied = 0;
+        if (!requests.empty()) {
+            requests.pop_front();
+        }
+    }
+
+    void StreamingLoader::acquire(const CommandList& commandList) {
+        for (const auto& release : releases) {
+            if (release.buffer) {
+                commandList.transferOwnership(
+                    *release.buffer, CommandType::TRANSFER, CommandType::GRAPHIC, release.offset, release.size);
+            } else {
+                commandList.transferOwnership(
+                    *release.image, CommandType::TRANSFER, CommandType::GRAPHIC, release.mipLevel, release.arrayLayer);
+            }
+        }
+        releases.clear();
+    }
+
+    void StreamingLoader::wait() {
+        while (!poll()) {
+            const auto failureGuard = FailureGuard{*this};
+            if (readCount > 0) {
+                const auto [index, readSize] = reader->wait();
+                copyChunk(static_cast<uint32_t>(index), readSize);
+            } else {
+                // All the slices are used by copies, wait for the oldest one
+                semaphore->wait(std::ranges::min_element(slices, {}, &Slice::value)->value);
+            }
+        }
+        semaphore->wait(semaphore->getValue());
+    }
+
+    void StreamingLoader::beginSlice(const Slice& slice) const {
+        slice.commandAllocator->reset();
+        slice.commandList->begin();
+    }
+
+    void StreamingLoader::submitSlice(Slice& slice) {
+        slice.commandList->end();
+        transferQueue->submit(WaitStage::TRANSFER, semaphore, {slice.commandList});
+        slice.value = semaphore->getValue();
+    }
+
+    std::shared_ptr<StreamingLoader> Vireo::createStreamingLoader(
+        const size_t sliceSize,
+        const uint32_t sliceCount,
+        const std::wstring& name) const {
+        return std::make_shared<StreamingLoader>(*this, sliceSize, sliceCount, name);
+    }
+
+    CommandListPool::CommandListPool(const Vireo& vireo, const CommandType type, const uint32_t framesInFlight) :
+        vireo{vireo},
+        type{type},
+        framesInFlight{framesInFlight},
+        id{[] {
+            static auto nextId = std::atomic<uint64_t>{1};
+            return nextId.fetch_add(1, std::memory_order_relaxed);
+        }()} {
+        assert(framesInFlight > 0);
+    }
+
+    void CommandListPool::reset(const uint32_t frameIndex, const Fence& fence) {
+        assert(frameIndex < framesInFlight);
+        // The command buffers of the frame can still be executing, resetting their allocator is undefined behavior
+        fence.wait();
+        auto lock = std::lock_guard(mutex);
+        for (const auto& threadPool : std::views::values(threads)) {
+            auto& frame = threadPool->frames[frameIndex];
+            if (frame.used > 0 || frame.usedSecondary > 0) {
+                frame.commandAllocator->reset();
+                frame.used = 0;
+                frame.usedSecondary = 0;
+            }
+        }
+        currentFrame = frameIndex;
+    }
+
+    std::shared_ptr<CommandList> CommandListPool::acquire() {
+        auto& frame = getThreadPool().frames[currentFrame];
+        if (frame.used == frame.commandLists.size()) {
+            // Only the first frames allocate, the next ones reuse the command lists
+            frame.commandLists.push_back(frame.commandAllocator->createCommandList());
+        }
+        return frame.commandLists[frame.used++];
+    }
+
+    std::shared_ptr<CommandList> CommandListPool::acquireSecondary() {
+        assert(type == CommandType::GRAPHIC);
+        auto& frame = getThreadPool().frames[currentFrame];
+        if (frame.usedSecondary == frame.secondaryCommandLists.size()) {
+            frame.secondaryCommandLists.push_back(frame.commandAllocator->createSecondaryCommandList());
+        }
+        return frame.secondaryCommandLists[frame.usedSecondary++];
+    }
+
+    void CommandListPool::releaseThread() {
+        auto& cache = getThreadCache();
+        if (cache.poolId == id) {
+            cache = {};
+        }
+        auto lock = std::lock_guard(mutex);
+        threads.erase(std::this_thread::get_id());
+    }
+
+    CommandListPool::ThreadPool& CommandListPool::getThreadPool() {
+        auto& cache = getThreadCache();
+        if (cache.poolId == id) {
+            return *cache.threadPool;
+        }
+        auto lock = std::lock_guard(mutex);
+        auto& threadPool = threads[std::this_thread::get_id()];
+        if (!threadPool) {
+            threadPool = std::make_unique<ThreadPool>();
+            for (uint32_t i = 0; i < framesInFlight; i++) {
+                threadPool->frames.push_back({ .commandAllocator = vireo.createCommandAllocator(type) });
+            }
+        }
+        cache = { .poolId = id, .threadPool = threadPool.get() };
+        return *threadPool;
+    }
+
+    CommandListPool::ThreadCache& CommandListPool::getThreadCache() {
+        static thread_local auto cache = ThreadCache{};
+        return cache;
+    }
+
+    std::shared_ptr<CommandListPool> Vireo::createCommandListPool(
+        const CommandType type,
+        const uint32_t framesInFlight) const {
+        return std::make_shared<CommandListPool>(*this, type, framesInFlight);
+    }
+
     uint32_t Image::getRowPitch(const uint32_t mipLevel) const {
         if (format >= ImageFormat::BC1_UNORM) {
             return (((width >> mipLevel) + 3) / 4) * pixelSize[static_cast<int>(format)];
@@ -90,6 +696,13 @@ namespace vireo {
         return (width >> mipLevel) * pixelSize[static_cast<int>(format)];
     }
 
+    uint32_t Image::getRowPitch(const ImageRegion& region) const {
+        if (format >= ImageFormat::BC1_UNORM) {
+            return ((region.width + 3) / 4) * pixelSize[static_cast<int>(format)];
+        }
+        return region.width * pixelSize[static_cast<int>(format)];
+    }
+
     uint32_t Image::getRowLength(const uint32_t mipLevel) const {
         if (format >= ImageFormat::BC1_UNORM) {
             return ((width >> mipLevel) + 3) & ~3;
@@ -7,6 +7,7 @@
 export module vireo;
 
 import std;
+import vireo.files;
 export import vireo.tools;
 
 export namespace vireo {
@@ -184,6 +185,45 @@ export namespace vireo {
         IMAGE_DOWNLOAD,
 };
 
+    /**
+     * Bitmask of additional buffer usages, combined with the usage implied by the BufferType.
+     * Used to share a buffer between passes without intermediate copies, for example a READWRITE_STORAGE buffer
+     * written by a compute shader then used as a VERTEX or INDIRECT buffer.
+     *
+     * Manual page : \ref manual_030_01_resources
+     */
+    enum class BufferUsage : uint32_t {
+        NONE              = 0x00000000,
+        //! Can be used as a vertex buffer
+        VERTEX            = 0x00000001,
+        //! Can be used as an index buffer
+        INDEX             = 0x00000002,
+        //! Can be used as a draw commands buffer for indirect drawing
+        INDIRECT          = 0x00000004,
+        //! Can be used as a shader uniform
+        UNIFORM           = 0x00000008,
+        //! Can be used as a read-only shader storage
+        STORAGE           = 0x00000010,
+        //! Can be used as a read/write shader storage
+        READWRITE_STORAGE = 0x00000020,
+        //! Can be used as the source of a copy
+        TRANSFER_SRC      = 0x00000040,
+        //! Can be used as the destination of a copy
+        TRANSFER_DST      = 0x00000080,
+        //! Written in place by the CPU : placed in device local memory writable by the CPU when the device
+        //! have some (resizable BAR, UMA) and within the budget, in host visible memory otherwise.
+        //! See Buffer::isDeviceLocal()
+        HOST_WRITE        = 0x00000100,
+    };
+
+    constexpr BufferUsage operator|(const BufferUsage a, const BufferUsage b) {
+        return static_cast<BufferUsage>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
+    }
+
+    constexpr BufferUsage operator&(const BufferUsage a, const BufferUsage b) {
+        return static_cast<BufferUsage>(static_cast<uint32_t>(a) & static_cast<uint32_t>(b));
+    }
+
     /**
      * Index type for vertex indices
      *
@@ -234,6 +274,20 @@ export namespace vireo {
         COMPUTE,
     };
 
+    /**
+     * How a command list is submitted between two recordings
+     *
+     * Manual page : \ref manual_050_00_commands
+     */
+    enum class CommandListUsage {
+        //! Submitted one or more times, never while a previous submission is still executing
+        DEFAULT,
+        //! Submitted once : the command list must be recorded again before the next submission
+        ONE_TIME_SUBMIT,
+        //! Recorded once and submitted many times, even while the previous submissions are still executing
+        SIMULTANEOUS_USE,
+    };
+
     /**
      * Size and type of a vertex attribute data
      *
@@ -607,6 +661,61 @@ export namespace vireo {
         X64  = 6
     };
 
+    /**
+     * Bitmask of the operations an image can be used for.
+     * Declaring the minimal set of usages lets the driver enable optimizations like framebuffer compression
+     * for images that are never sampled or copied.
+     *
+     * Manual page : \ref manual_030_02_resources
+     */
+    enum class ImageUsage : uint32_t {
+        //! Usages selected by the backend : transfers and sampling, plus the attachment for render targets
+        DEFAULT      = 0x00000000,
+        //! Can be read by a shader through a sampler
+        SAMPLED      = 0x00000001,
+        //! Can be read and written by a shader
+        STORAGE      = 0x00000002,
+        //! Can be the source of a copy
+        TRANSFER_SRC = 0x00000004,
+        //! Can be the destination of a copy or an upload
+        TRANSFER_DST = 0x00000008,
+        //! Can be used as a color or depth attachment, implied for render targets
+        ATTACHMENT   = 0x00000010,
+        //! Render target only used inside one render pass, like MSAA or depth attachments that are resolved
+        //! or discarded at the end of the pass. Can't be combined with other usages.
+        //! The memory is lazily allocated if the device supports it.
+        TRANSIENT    = 0x00000020,
+        //! Can be the destination of Vireo::upload() host copies, added to the other usages.
+        //! Only if Vireo::isHostImageCopySupported() returns `true`
+        HOST_TRANSFER = 0x00000040,
+    };
+
+    constexpr ImageUsage operator|(const ImageUsage a, const ImageUsage b) {
+        return static_cast<ImageUsage>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
+    }
+
+    constexpr ImageUsage operator&(const ImageUsage a, const ImageUsage b) {
+        return static_cast<ImageUsage>(static_cast<uint32_t>(a) & static_cast<uint32_t>(b));
+    }
+
+    /**
+     * Class of the resources a memory heap can hold.
+     * DirectX devices with resource heap tier 1 can't mix buffers, images and render targets in one heap,
+     * and with Vulkan the memory types accepted by each class of resources can differ.
+     *
+     * Manual page : \ref manual_030_00_resources
+     */
+    enum class MemoryHeapUsage {
+        //! Buffers, images and render targets
+        ALL,
+        //! Buffers only
+        BUFFERS,
+        //! Images that are not render targets
+        IMAGES,
+        //! Color and depth render targets only
+        RENDER_TARGETS,
+    };
+
     /**
      * Presentation mode for a surface
      *
@@ -771,21 +880,67 @@ export namespace vireo {
     }
 
     /**
-     * Use of memory allocation
+     * Number and total size of the live buffers of a type or of the live images
      */
-    enum class VideoMemoryAllocationUsage {
-        BUFFER,
-        IMAGE
+    struct VideoMemoryUsage {
+        //! Number of live resources
+        uint32_t count{0};
+        //! Total size in bytes of the live resources
+        size_t   size{0};
     };
 
     /**
-     * Description of a memory allocation
+     * Usage and budget of a device memory heap
      */
-    struct VideoMemoryAllocationDesc {
-        VideoMemoryAllocationUsage usage;
-        std::wstring name;
-        size_t size;
-        void* ref;
+    struct VideoMemoryHeapBudget {
+        //! Size of the heap in bytes
+        size_t size{0};
+        //! `true` if the heap is in the device local memory (VRAM)
+        bool   deviceLocal{false};
+        //! Bytes of the heap allocated by Vireo
+        size_t allocated{0};
+        //! Bytes of the heap used by the process as reported by the driver, `allocated` if not available
+        size_t usage{0};
+        //! Bytes of the heap the process can use before allocations fail or degrade performance,
+        //! `size` if not available
+        size_t budget{0};
+    };
+
+    /**
+     * Snapshot of the usage and budget of the device memory heaps
+     */
+    struct VideoMemoryBudget {
+        static constexpr uint32_t MAX_HEAPS{16};
+        //! Number of heaps
+        uint32_t heapCount{0};
+        std::array<VideoMemoryHeapBudget, MAX_HEAPS> heaps{};
+    };
+
+    /**
+     * Usage and fragmentation of the device memory blocks sub-allocated by Vireo
+     */
+    struct VideoMemoryStatistics {
+        //! Number of device memory blocks, dedicated blocks included
+        uint32_t blockCount{0};
+        //! Number of blocks allocated for a single large resource
+        uint32_t dedicatedBlockCount{0};
+        //! Number of resources living in the blocks
+        uint32_t allocationCount{0};
+        //! Total size in bytes of the blocks
+        size_t   blockBytes{0};
+        //! Bytes of the blocks used by the resources
+        size_t   allocatedBytes{0};
+        //! Number of free ranges in all the blocks
+        uint32_t freeRangeCount{0};
+        //! Total size in bytes of the free ranges
+        size_t   freeBytes{0};
+        //! Size in bytes of the largest free range
+        size_t   largestFreeRange{0};
+
+        //! Returns 0.0 if all the free memory is in a single range and tends to 1.0 when the free memory is scattered
+        float getFragmentation() const {
+            return freeBytes == 0 ? 0.0f : 1.0f - static_cast<float>(largestFreeRange) / static_cast<float>(freeBytes);
+        }
     };
 
     /**
@@ -849,6 +1004,17 @@ export namespace vireo {
         */
         void decrementValue() { value--; }
 
+        /**
+         * Returns the last value signaled by the GPU, without blocking. Only for timeline semaphores.
+         */
+        virtual uint64_t getCompletedValue() const = 0;
+
+        /**
+         * Blocks the calling thread until the GPU signals a value. Only for timeline semaphores.
+         * @param value Value to wait for
+         */
+        virtual void wait(uint64_t value) const = 0;
+
         virtual ~Semaphore() = default;
         Semaphore (const Semaphore&) = delete;
         Semaphore& operator= (const Semaphore&) = delete;
@@ -928,6 +1094,16 @@ export namespace vireo {
          */
         auto getType() const { return type; }
 
+        /**
+         * Returns the additional usages of the buffer
+         */
+        auto getUsage() const { return usage; }
+
+        /**
+         * Returns `true` if one of the usages was added to the buffer at creation
+         */
+        auto hasUsage(const BufferUsage usages) const { return (usage & usages) != BufferUsage::NONE; }
+
         /**
          * Returns the size of a data instance, in bytes
          */
@@ -949,7 +1125,9 @@ export namespace vireo {
         auto getMappedAddress() const { return mappedAddress; }
 
         /**
-         * Maps the device memory associated with the buffer into a host adress sapce
+         * Maps the device memory associated with the buffer into a host adress sapce.
+         * The mapped memory of the download buffers is invalidated, the GPU writes finished before the call are
+         * visible to the host.
          */
         virtual void map() = 0;
 
@@ -967,12 +1145,62 @@ export namespace vireo {
         void write(const void* data, size_t size = WHOLE_SIZE, size_t offset = 0) const;
 
         /**
-         * Returns the currently allocated buffers.
+         * Returns `true` if the buffer stays mapped for its whole life. map() and unmap() are ignored for those buffers.
+         */
+        auto isPersistentlyMapped() const { return persistentlyMapped; }
+
+        /**
+         * Returns `true` if the buffer memory is in the device local memory, always `true` on UMA devices
+         */
+        auto isDeviceLocal() const { return deviceLocal; }
+
+        /**
+         * Returns `true` if the host and the device always see the same content of the mapped memory.
+         * Non-coherent memory (cached memory of the download buffers) needs flush() and invalidate() calls.
+         */
+        auto isHostCoherent() const { return hostCoherent; }
+
+        /**
+         * Makes the host writes in a range of the mapped memory visible to the device.
+         * Does nothing for host coherent memory. Buffer must be mapped before.
+         * @param offset Offset in bytes of the range, from the mapped address
+         * @param size Size in bytes of the range
+         */
+        virtual void flush(size_t offset = 0, size_t size = WHOLE_SIZE) const {}
+
+        /**
+         * Makes the device writes in a range of the mapped memory visible to the host, call it
+         * after the GPU has written the buffer and before reading the mapped memory.
+         * Does nothing for host coherent memory. Buffer must be mapped before.
+         * @param offset Offset in bytes of the range, from the mapped address
+         * @param size Size in bytes of the range
+         */
+        virtual void invalidate(size_t offset = 0, size_t size = WHOLE_SIZE) const {}
+
+        /**
+         * Returns the number of copies of the buffer content, see discard()
+         */
+        auto getVersionCount() const { return versionCount; }
+
+        /**
+         * Returns the offset in bytes of the current copy of the buffer content.
+         * Add this offset to the dynamic uniform offset or to the copy offsets when using a multi-versions buffer.
+         */
+        size_t getCurrentOffset() const { return currentVersion * versionSize; }
+
+        /**
+         * Switches to the next copy of the buffer content before writing a new content, like a WRITE_DISCARD map.
+         * The previous copies are left untouched while the GPU is still reading them. Buffer must be mapped before.
+         */
+        void discard();
+
+        /**
+         * Returns the number and the total size of the live buffers of a type.
          * Only available if isMemoryUsageEnabled() is `true`
          */
-        static auto getMemoryAllocations() { return memoryAllocations; }
+        static VideoMemoryUsage getMemoryUsage(BufferType type);
 
-        virtual ~Buffer() = default;
+        virtual ~Buffer();
         Buffer (const Buffer&) = delete;
         Buffer& operator = (const Buffer&) = delete;
 
@@ -981,15 +1209,40 @@ export namespace vireo {
         uint32_t instanceSize{0};
         uint32_t instanceCount{0};
         uint32_t instanceSizeAligned{0};
+        // Host address of the current copy of the content
         void*    mappedAddress{nullptr};
+        bool     persistentlyMapped{false};
+        bool     deviceLocal{false};
+        bool     hostCoherent{true};
+        uint32_t versionCount{1};
+        uint32_t currentVersion{0};
+        // Aligned size of one copy of the content
+        size_t   versionSize{0};
 
-        Buffer(const BufferType type): type{type} {}
+        Buffer(const BufferType type, const BufferUsage usage = BufferUsage::NONE): type{type}, usage{usage} {}
 
-        static std::mutex memoryAllocationsMutex;
-        static std::list<VideoMemoryAllocationDesc> memoryAllocations;
+        // Adds the buffer to the memory usage counters, the destructor removes it
+        void trackMemoryUsage(size_t size);
+
+        // Hands the tracked size over to a deferred free, which calls untrackMemoryUsage() once the memory is freed
+        size_t detachMemoryUsage();
+
+        // Removes a buffer from the memory usage counters
+        static void untrackMemoryUsage(BufferType type, size_t size);
 
     private:
-        const BufferType type;
+        struct MemoryUsageCounters {
+            std::atomic<uint32_t> count{0};
+            std::atomic<size_t>   size{0};
+        };
+
+        static constexpr auto BUFFER_TYPE_COUNT{static_cast<size_t>(BufferType::IMAGE_DOWNLOAD) + 1};
+        // Lock-free counters indexed by buffer type
+        static std::array<MemoryUsageCounters, BUFFER_TYPE_COUNT> memoryUsage;
+
+        const BufferType  type;
+        const BufferUsage usage;
+        size_t            trackedSize{0};
     };
 
     /**
@@ -1009,6 +1262,28 @@ export namespace vireo {
         Sampler() = default;
     };
 
+    /**
+     * Rectangle of an image level and layer, used to update a part of an image.
+     * The offsets and the extent of the compressed formats are multiples of the 4x4 blocks
+     * (except for the extent at the right and bottom borders of a level).
+     *
+     * Manual page : \ref manual_030_02_resources
+     */
+    struct ImageRegion {
+        //! Horizontal offset in pixels
+        uint32_t x{0};
+        //! Vertical offset in pixels
+        uint32_t y{0};
+        //! Width in pixels
+        uint32_t width{0};
+        //! Height in pixels
+        uint32_t height{0};
+        //! Level of the image
+        uint32_t mipLevel{0};
+        //! Layer of the image array
+        uint32_t arrayLayer{0};
+    };
+
     /**
      * An image object
      *
@@ -1143,14 +1418,14 @@ export namespace vireo {
          * Return the size in bytes
          */
         auto getImageSize(const uint32_t mipLevel = 0) const {
-            return getRowPitch(mipLevel) * height;
+            return size_t{getRowPitch(mipLevel)} * height;
         }
 
         /**
          * Return the aligned size in bytes for a level
          */
         auto getAlignedImageSize(const uint32_t mipLevel = 0) const {
-            return getAlignedRowPitch(mipLevel) * height;
+            return size_t{getAlignedRowPitch(mipLevel)} * height;
         }
 
         /**
@@ -1169,23 +1444,53 @@ export namespace vireo {
             return (getRowLength(mipLevel) + (texelSize - 1)) & ~(texelSize - 1);
         }
 
+        /**
+         * Return the size in bytes of each row of a region (a row of 4x4 blocks for the compressed formats)
+         */
+        uint32_t getRowPitch(const ImageRegion& region) const;
+
+        /**
+         * Return the size in bytes of the aligned rows of a region
+         */
+        uint32_t getAlignedRowPitch(const ImageRegion& region) const {
+            return (getRowPitch(region) + (IMAGE_ROW_PITCH_ALIGNMENT - 1)) & ~(IMAGE_ROW_PITCH_ALIGNMENT - 1);
+        }
+
+        /**
+         * Return the number of rows of a region (rows of 4x4 blocks for the compressed formats)
+         */
+        uint32_t getRowCount(const ImageRegion& region) const {
+            return format >= ImageFormat::BC1_UNORM ? (region.height + 3) / 4 : region.height;
+        }
+
         /**
          * Return `true` if the image have read/write access
          */
         auto isReadWrite() const { return readWrite; }
 
+        /**
+         * Returns the usages declared at creation, ImageUsage::DEFAULT (or only ImageUsage::HOST_TRANSFER)
+         * if the backend selected them
+         */
+        auto getUsage() const { return usage; }
+
+        /**
+         * Returns `true` if one of the usages was explicitly declared at creation
+         */
+        auto hasUsage(const ImageUsage usages) const { return (usage & usages) != ImageUsage::DEFAULT; }
+
         /**
          * Returns the number of bytes for one pixel, or the block size in bytes pour BCn compressed formats
          */
         static auto getPixelSize(const ImageFormat format) { return pixelSize[static_cast<int>(format)]; }
 
         /**
-         * Returns the currently allocated images.
+         * Returns the number and the total size of the live images.
          * Only available if isMemoryUsageEnabled() is `true`
          */
-        static auto getMemoryAllocations() { return memoryAllocations; }
+        static VideoMemoryUsage getMemoryUsage();
 
-        virtual ~Image() = default;
+        virtual ~Image();
         Image (Image&) = delete;
         Image& operator = (const Image&) = delete;
 
@@ -1196,16 +1501,24 @@ export namespace vireo {
             const uint32_t height,
             const uint32_t mipLevels,
             const uint32_t arraySize,
-            const bool isReadWrite) :
+            const bool isReadWrite,
+            const ImageUsage usage = ImageUsage::DEFAULT) :
             format{format},
             width{width},
             height{height},
             mipLevels{mipLevels},
             arraySize{arraySize},
-            readWrite{isReadWrite} {}
+            readWrite{isReadWrite},
+            usage{usage} {}
+
+        // Adds the image to the memory usage counters, the destructor removes it
+        void trackMemoryUsage(size_t size);
 
-        static std::mutex memoryAllocationsMutex;
-        static std::list<VideoMemoryAllocationDesc> memoryAllocations;
+        // Hands the tracked size over to a deferred free, which calls untrackMemoryUsage() once the memory is freed
+        size_t detachMemoryUsage();
+
+        // Removes an image from the memory usage counters
+        static void untrackMemoryUsage(size_t size);
 
     private:
         const ImageFormat format;
@@ -1214,6 +1527,11 @@ export namespace vireo {
         const uint32_t    mipLevels;
         const uint32_t    arraySize;
         const bool        readWrite;
+        const ImageUsage  usage;
+        size_t            trackedSize{0};
+
+        static std::atomic<uint32_t> memoryUsageCount;
+        static std::atomic<size_t>   memoryUsageSize;
     };
 
     /**
@@ -1246,6 +1564,50 @@ export namespace vireo {
         const std::shared_ptr<Image> image;
     };
 
+    /**
+     * A block of device memory shared by placed resources.
+     * Placed resources are created at a given offset in the heap and resources with non-overlapping lifetimes
+     * can share the same memory range. Before using a resource that reuses the memory of another one, an aliasing
+     * barrier must be recorded with CommandList::barrier() and the content of the new resource is undefined.
+     *
+     * Manual page : \ref manual_030_00_resources
+     */
+    class MemoryHeap {
+    public:
+        //! Alignment of the offsets of the placed resources in a heap
+        static constexpr size_t PLACEMENT_ALIGNMENT{64 * 1024};
+        //! Alignment of the offsets of the MSAA render targets placed in a heap
+        static constexpr size_t MSAA_PLACEMENT_ALIGNMENT{4 * 1024 * 1024};
+
+        /**
+         * Returns the size in bytes of the heap
+         */
+        auto getSize() const { return size; }
+
+        /**
+         * Returns the class of resources the heap can hold
+         */
+        auto getUsage() const { return usage; }
+
+        /**
+         * Returns `true` if a class of resources can be placed in the heap
+         */
+        bool isUsageAllowed(const MemoryHeapUsage resourceUsage) const {
+            return usage == MemoryHeapUsage::ALL || usage == resourceUsage;
+        }
+
+        virtual ~MemoryHeap() = default;
+        MemoryHeap (MemoryHeap&) = delete;
+        MemoryHeap& operator = (const MemoryHeap&) = delete;
+
+    protected:
+        MemoryHeap(const size_t size, const MemoryHeapUsage usage) : size{size}, usage{usage} {}
+
+    private:
+        const size_t          size;
+        const MemoryHeapUsage usage;
+    };
+
     /**
      * A descriptor set layout object.
      * Describes resources that shaders can use.
@@ -1546,6 +1908,9 @@ export namespace vireo {
         ClearValue                     depthStencilClearValue{ .depthStencil = {1.0f, 0} };
         //! Discard the content of the depth and stencil attachment after rendering
         bool                           discardDepthStencilAfterRender{false};
+        //! The commands of the render pass are recorded in secondary command lists executed with
+        //! CommandList::executeCommands() instead of being recorded in the command list beginning the render pass
+        bool                           secondaryCommandLists{false};
     };
 
     /**
@@ -1591,6 +1956,16 @@ export namespace vireo {
         size_t size;
     };
 
+    /**
+     * Range of instances of a buffer
+     */
+    struct BufferInstanceRange {
+        //! Index of the first instance
+        uint32_t firstInstance{0};
+        //! Number of instances
+        uint32_t instanceCount{1};
+    };
+
     /**
      * A command list (buffer) object
      *
@@ -1604,9 +1979,23 @@ export namespace vireo {
         };
 
         /**
-         * Start recording a command list
+         * Start recording a command list, discarding the previously recorded commands
+         * @param usage How the command list will be submitted until the next recording
+         */
+        virtual void begin(CommandListUsage usage = CommandListUsage::DEFAULT) const = 0;
+
+        /**
+         * Start recording a secondary command list executed inside a render pass.
+         * The secondary command list inherits the attachments formats of the render pass but no other state :
+         * bind the pipelines, descriptor sets and buffers and set the viewports and scissors in each secondary
+         * command list. The DirectX bundles keep the viewports and scissors of the executing command list, set them
+         * in the primary command list too.
+         * @param configuration Configuration of the render pass, started with RenderingConfiguration::secondaryCommandLists
+         * @param usage How the command list will be executed until the next recording
          */
-        virtual void begin() const = 0;
+        virtual void begin(
+            const RenderingConfiguration& configuration,
+            CommandListUsage usage = CommandListUsage::DEFAULT) const = 0;
 
         /**
          * Stop recording a command list
@@ -1629,6 +2018,32 @@ export namespace vireo {
             upload(*destination, source);
         }
 
+        /**
+         * Uploads a range of bytes into a buffer using a temporary (staging) buffer.
+         * The data is copied as is, you are responsible for the alignment of the instances.
+         * @param destination Destination buffer
+         * @param source Source data
+         * @param size Size in bytes of the source data
+         * @param offset Offset in bytes in the destination buffer
+         */
+        virtual void upload(
+            const Buffer& destination,
+            const void* source,
+            size_t size,
+            size_t offset) = 0;
+
+        /**
+         * Uploads some instances of a buffer using a temporary (staging) buffer.
+         * Only the instances in the ranges are staged and copied, using the aligned instance size of the buffer.
+         * @param destination Destination buffer
+         * @param source Source data for the whole buffer, with the same layout as for the whole buffer upload()
+         * @param ranges Ranges of instances to upload
+         */
+        virtual void upload(
+            const Buffer& destination,
+            const void* source,
+            const std::vector<BufferInstanceRange>& ranges) = 0;
+
         /**
          * Uploads data into buffers using temporary (staging) buffers.
          */
@@ -1657,6 +2072,32 @@ export namespace vireo {
          */
         virtual void upload(const std::vector<ImageUploadInfo>& infos);
 
+        /**
+         * Uploads data into a rectangle of an image level and layer using a temporary (staging) buffer,
+         * the rest of the image is left untouched. The image must be in the COPY_DST state.
+         * @param destination Destination image
+         * @param source Packed rows of the region pixels
+         * @param region Rectangle to update
+         */
+        virtual void upload(
+            const Image& destination,
+            const void* source,
+            const ImageRegion& region) = 0;
+
+        /**
+         * Uploads data into a rectangle of an image level and layer using a temporary (staging) buffer,
+         * the rest of the image is left untouched. The image must be in the COPY_DST state.
+         * @param destination Destination image
+         * @param source Packed rows of the region pixels
+         * @param region Rectangle to update
+         */
+        void upload(
+            const std::shared_ptr<const Image>& destination,
+            const void* source,
+            const ImageRegion& region) {
+            upload(*destination, source, region);
+        }
+
         /**
         * Copy data from a buffer into an image level.
         * If `rowPitchAlignment` is `true` (for Vulkan), the data in the buffer must have row-aligned data (cf. `Image::IMAGE_ROW_PITCH_ALIGNMENT`) for cross-API compatibility.
@@ -1664,7 +2105,7 @@ export namespace vireo {
         void copy(
             const std::shared_ptr<Buffer>& source,
             const std::shared_ptr<const Image>& destination,
-            const uint32_t sourceOffset = 0,
+            const size_t sourceOffset = 0,
             const uint32_t mipLevel = 0,
             const bool rowPitchAlignment = true) const {
             copy(*source, *destination, sourceOffset, mipLevel, rowPitchAlignment);
@@ -1677,7 +2118,7 @@ export namespace vireo {
         virtual void copy(
             const Buffer& source,
             const Image& destination,
-            uint32_t sourceOffset = 0,
+            size_t sourceOffset = 0,
             uint32_t mipLevel = 0,
             bool rowPitchAlignment = true) const = 0;
 
@@ -1705,13 +2146,28 @@ export namespace vireo {
             const std::vector<size_t>& sourceOffsets,
             bool rowPitchAlignment = true) const = 0;
 
+        /**
+         * Copy data from a buffer into a rectangle of an image level and layer.
+         * The rows in the buffer must be aligned on `Image::IMAGE_ROW_PITCH_ALIGNMENT` (cf. Image::getAlignedRowPitch(const ImageRegion&))
+         * and `sourceOffset` must be a multiple of 512 bytes for cross-API compatibility.
+         * @param source Source buffer
+         * @param destination Destination image, in the COPY_DST state
+         * @param region Rectangle to update
+         * @param sourceOffset Offset in bytes of the first row in the buffer
+         */
+        virtual void copy(
+            const Buffer& source,
+            const Image& destination,
+            const ImageRegion& region,
+            size_t sourceOffset = 0) const = 0;
+
         /**
         * Copy a level of an image into a buffer
         */
         virtual void copy(
            const Image& source,
            const Buffer& destination,
-           uint32_t destinationOffset = 0,
+           size_t destinationOffset = 0,
            uint32_t mipLevel = 0) const = 0;
 
         /**
@@ -1720,7 +2176,7 @@ export namespace vireo {
         void copy(
             const std::shared_ptr<const Image>& source,
             const std::shared_ptr<Buffer>& destination,
-            const uint32_t destinationOffset = 0,
+            const size_t destinationOffset = 0,
             const uint32_t firstMipLevel = 0) const {
             copy(*destination, *source, destinationOffset, firstMipLevel);
         }
@@ -1732,8 +2188,8 @@ export namespace vireo {
             const Buffer& source,
             const Buffer& destination,
             size_t size = Buffer::WHOLE_SIZE,
-            uint32_t sourceOffset = 0,
-            uint32_t destinationOffset = 0) const = 0;
+            size_t sourceOffset = 0,
+            size_t destinationOffset = 0) const = 0;
 
         /**
          * Copy data from a buffer into another buffer
@@ -1742,8 +2198,8 @@ export namespace vireo {
             const std::shared_ptr<const Buffer>& source,
             const std::shared_ptr<const Buffer>& destination,
             const size_t size = Buffer::WHOLE_SIZE,
-            const uint32_t sourceOffset = 0,
-            const uint32_t destinationOffset = 0) const {
+            const size_t sourceOffset = 0,
+            const size_t destinationOffset = 0) const {
             copy(*source, *destination, size, sourceOffset, destinationOffset);
         }
 
@@ -1827,6 +2283,13 @@ export namespace vireo {
          */
         virtual void endRendering() {}
 
+        /**
+         * Executes secondary command lists inside the current render pass, started with
+         * RenderingConfiguration::secondaryCommandLists. The state of the command list is undefined afterward.
+         * @param commandLists Secondary command lists, recorded with begin(const RenderingConfiguration&, CommandListUsage)
+         */
+        virtual void executeCommands(const std::vector<std::shared_ptr<const CommandList>>& commandLists) = 0;
+
         /**
          * Dispatch compute work items
          * @param x The number of local workgroups to dispatch in the X dimension.
@@ -2169,11 +2632,74 @@ export namespace vireo {
             ResourceState oldState,
             ResourceState newState) const = 0;
 
+        /**
+         * Insert an aliasing barrier between two images placed in the same MemoryHeap memory range.
+         * The content of the `after` image is undefined and must be transitioned from ResourceState::UNDEFINED.
+         * @param before The image that was using the memory, or `nullptr` for any placed resource
+         * @param after The image that will use the memory
+         */
+        virtual void barrier(
+            const std::shared_ptr<const Image>& before,
+            const std::shared_ptr<const Image>& after) const = 0;
+
+        /**
+         * Insert an aliasing barrier between two buffers placed in the same MemoryHeap memory range.
+         * The content of the `after` buffer is undefined.
+         * @param before The buffer that was using the memory
+         * @param after The buffer that will use the memory
+         */
+        virtual void barrier(
+            const Buffer& before,
+            const Buffer& after) const = 0;
+
+        /**
+         * Transfers the ownership of a range of a buffer between the queues of two command types, needed when they
+         * use different Vulkan queue families : for example a buffer written by a TRANSFER queue and read by a
+         * GRAPHIC queue. Record it with the same parameters after the last write in a command list of the `source`
+         * type (release), then before the first use in a command list of the `destination` type (acquire) submitted
+         * after the release with a semaphore.
+         * Does nothing with DirectX and when the two command types use the same queue family.
+         * @param buffer The buffer
+         * @param source Command type of the queue releasing the buffer
+         * @param destination Command type of the queue acquiring the buffer
+         * @param offset Offset in bytes of the range
+         * @param size Size in bytes of the range
+         */
+        virtual void transferOwnership(
+            const Buffer& buffer,
+            CommandType source,
+            CommandType destination,
+            size_t offset = 0,
+            size_t size = Buffer::WHOLE_SIZE) const {}
+
+        /**
+         * Transfers the ownership of a level and a layer of an image in the COPY_DST state between the queues of two
+         * command types, see transferOwnership(const Buffer&, CommandType, CommandType, size_t, size_t)
+         * @param image The image, in the COPY_DST state on both queues
+         * @param source Command type of the queue releasing the image
+         * @param destination Command type of the queue acquiring the image
+         * @param mipLevel The mip level
+         * @param arrayLayer The array layer
+         */
+        virtual void transferOwnership(
+            const Image& image,
+            CommandType source,
+            CommandType destination,
+            uint32_t mipLevel = 0,
+            uint32_t arrayLayer = 0) const {}
+
         /**
          * Cleanup staging buffers used by `upload` functions
          */
         virtual void cleanup() = 0;
 
+        /**
+         * Returns the number of binds and dynamic state changes not recorded since begin()
+         * because they were identical to the state already set in the command list.
+         * Always 0 for the backends that do not filter the redundant state.
+         */
+        virtual uint32_t getSkippedStateCount() const { return 0; }
+
         virtual ~CommandList() = default;
         CommandList (CommandList&) = delete;
         CommandList& operator = (const CommandList&) = delete;
@@ -2182,6 +2708,9 @@ export namespace vireo {
         CommandList() = default;
         // Last bound pipeline
         Pipeline* currentlyBoundPipeline{nullptr};
+
+        // Sorts the instance ranges and merges the overlapping & adjacent ranges
+        static std::vector<BufferInstanceRange> mergeInstanceRanges(const std::vector<BufferInstanceRange>& ranges);
     };
 
     /**
@@ -2215,6 +2744,12 @@ export namespace vireo {
          */
         virtual std::shared_ptr<CommandList> createCommandList() const  = 0;
 
+        /**
+         * Returns a new secondary command list (a bundle with DirectX), executed by another command list with
+         * CommandList::executeCommands(). Only for CommandType::GRAPHIC allocators.
+         */
+        virtual std::shared_ptr<CommandList> createSecondaryCommandList() const  = 0;
+
         /**
          * Returns the type of command list created by this allocator
          */
@@ -2524,6 +3059,418 @@ export namespace vireo {
         bool              alphaToCoverageEnable{false};
     };
 
+    class ReadbackRing;
+
+    /**
+     * Handle of a GPU to host copy recorded with ReadbackRing::download().
+     * The data are readable once the GPU has signaled the semaphore value of the readback.
+     * Dropping the handle gives the range back to the ring.
+     *
+     * Manual page : \ref manual_030_01_resources
+     */
+    class Readback {
+    public:
+        /**
+         * Returns `true` if the GPU has finished the copy. Never blocks.
+         */
+        bool isReady() const;
+
+        /**
+         * Blocks the calling thread until the GPU has finished the copy
+         */
+        void wait() const;
+
+        /**
+         * Returns the host address of the downloaded data, after invalidating the host caches of non-coherent memory.
+         * The readback must be ready.
+         */
+        const void* getData() const;
+
+        /**
+         * Returns the size in bytes of the downloaded data
+         */
+        auto getSize() const { return size; }
+
+        /**
+         * Returns the value of the ring semaphore signaled by the GPU at the end of the copy
+         */
+        auto getValue() const { return value; }
+
+        ~Readback();
+        Readback (const Readback&) = delete;
+        Readback& operator = (const Readback&) = delete;
+
+    private:
+        friend class ReadbackRing;
+
+        ReadbackRing&  ring;
+        const uint64_t id;
+        const size_t   offset;
+        const size_t   size;
+        const uint64_t value;
+
+        Readback(ReadbackRing& ring, uint64_t id, size_t offset, size_t size, uint64_t value);
+    };
+
+    /**
+     * Persistently mapped host memory sub-allocated linearly for the GPU to host copies.
+     * Each download returns a Readback that can be polled every frame without stalling the CPU.
+     * The command list recording the downloads must signal the ring semaphore when submitted : the readbacks
+     * are ready when the GPU reaches the next value of the semaphore.
+     * The ring must outlive its readbacks.
+     *
+     * Manual page : \ref manual_030_01_resources
+     */
+    class ReadbackRing {
+    public:
+        //! Default size of the ring in bytes
+        static constexpr size_t DEFAULT_SIZE{16 * 1024 * 1024};
+        //! Alignment of the ranges, suitable for the image to buffer copies of all the backends
+        static constexpr size_t ALIGNMENT{512};
+
+        /**
+         * Records the copy of a buffer range into the ring.
+         * Returns `nullptr` if the ring has no free range large enough, without recording anything.
+         * @param commandList Command list recording the copy
+         * @param source Source buffer
+         * @param size Size in bytes of the range to copy
+         * @param sourceOffset Offset in bytes of the range in the source buffer
+         */
+        std::shared_ptr<Readback> download(
+            const CommandList& commandList,
+            const Buffer& source,
+            size_t size = Buffer::WHOLE_SIZE,
+            size_t sourceOffset = 0);
+
+        /**
+         * Records the copy of an image level into the ring. The image must be in the COPY_SRC state and the rows
+         * of the data follow the layout of CommandList::copy(const Image&, const Buffer&, size_t, uint32_t).
+         * Returns `nullptr` if the ring has no free range large enough, without recording anything.
+         * @param commandList Command list recording the copy
+         * @param source Source image
+         * @param mipLevel Level to copy
+         */
+        std::shared_ptr<Readback> download(
+            const CommandList& commandList,
+            const Image& source,
+            uint32_t mipLevel = 0);
+
+        /**
+         * Returns the timeline semaphore to signal when submitting the command lists recording downloads
+         */
+        auto getSemaphore() const { return semaphore; }
+
+        /**
+         * Returns the size in bytes of the ring
+         */
+        auto getSize() const { return buffer->getSize(); }
+
+        ReadbackRing(const std::shared_ptr<Buffer>& buffer, const std::shared_ptr<Semaphore>& semaphore);
+        ~ReadbackRing();
+        ReadbackRing (const ReadbackRing&) = delete;
+        ReadbackRing& operator = (const ReadbackRing&) = delete;
+
+    private:
+        friend class Readback;
+
+        struct InFlightRange {
+            uint64_t id;
+            // Start of the range, alignment padding and wasted end of the ring included
+            size_t   start;
+            // Semaphore value signaled at the end of the copy
+            uint64_t value;
+            bool     released{false};
+        };
+
+        const std::shared_ptr<Buffer>    buffer;
+        const std::shared_ptr<Semaphore> semaphore;
+        // Next free byte, the used bytes are between the start of the oldest range and head
+        size_t                           head{0};
+        uint64_t                         nextId{1};
+        std::deque<InFlightRange>        inFlight;
+        std::mutex                       mutex;
+
+        // Reserves a range for a copy and returns the readback, or nullptr if the ring is full
+        std::shared_ptr<Readback> allocate(size_t size);
+
+        // Releases a range, the memory is reused once the older ranges are released and the GPU is done with them
+        void release(uint64_t id);
+
+        // Frees the oldest ranges released by their readbacks and finished by the GPU, the lock must be held
+        void recycle();
+    };
+
+    class Vireo;
+
+    /**
+     * Streams byte ranges of files into buffers and images through a few fixed size staging slices.
+     * The file content is read directly into the persistently mapped slices and copied by a transfer queue
+     * while the next slice is read, so large assets never need a staging buffer of their size.
+     * The loads are queued and never block the calling thread : poll() submits the reads and records the copies of the
+     * chunks already read, call it regularly (once per frame for example) until it returns `true`.
+     * On Linux the files are read asynchronously with io_uring, bypassing the page cache for the buffers ranges when
+     * possible, with one read in flight per free slice.
+     * A loader must be used by one thread at a time.
+     *
+     * Manual page : \ref manual_030_00_resources
+     */
+    class StreamingLoader {
+    public:
+        //! Default size of a staging slice in bytes
+        static constexpr size_t DEFAULT_SLICE_SIZE{32 * 1024 * 1024};
+        //! Default number of staging slices
+        static constexpr uint32_t DEFAULT_SLICE_COUNT{3};
+
+        /**
+         * Queues the streaming of a byte range of a file into a buffer.
+         * The load is done by poll() or wait(), the destination must stay alive until then.
+         * @param file Source file
+         * @param fileOffset Offset in bytes of the range in the file
+         * @param size Size in bytes of the range
+         * @param destination Destination buffer, a VERTEX, INDEX, INDIRECT, DEVICE_STORAGE or READWRITE_STORAGE buffer
+         * or a buffer with the BufferUsage::TRANSFER_DST usage
+         * @param destinationOffset Offset in bytes of the range in the destination buffer
+         */
+        void load(
+            const std::filesystem::path& file,
+            size_t fileOffset,
+            size_t size,
+            const Buffer& destination,
+            size_t destinationOffset = 0);
+
+        /**
+         * Queues the streaming of the packed rows of an image level stored in a file into a level and a layer of an
+         * image. Large levels are copied by bands of rows. The image must be in the COPY_DST state and a row,
+         * aligned on Image::IMAGE_ROW_PITCH_ALIGNMENT, must fit in a staging slice.
+         * The load is done by poll() or wait(), the destination must stay alive until then.
+         * @param file Source file
+         * @param fileOffset Offset in bytes of the level in the file
+         * @param destination Destination image
+         * @param mipLevel Level to load
+         * @param arrayLayer Layer to load
+         */
+        void load(
+            const std::filesystem::path& file,
+            size_t fileOffset,
+            const Image& destination,
+            uint32_t mipLevel = 0,
+            uint32_t arrayLayer = 0);
+
+        /**
+         * Submits the reads of the queued loads in the free slices and the copies of the chunks already read,
+         * without blocking the calling thread. A load failing to read its file is dropped and the error thrown.
+         * @return `true` when the copies of all the queued loads are submitted
+         */
+        bool poll();
+
+        /**
+         * Records in a GRAPHIC command list the acquisition of the resources loaded since the last call.
+         * With Vulkan the copies run on a transfer queue family, the loader releases the ownership of the loaded
+         * ranges and levels to the graphic queue family after the copies, see CommandList::transferOwnership().
+         * Submit the command list after the copies with getSemaphore(), before any other use of the resources,
+         * and keep the resources alive until then. Does nothing with DirectX or when the graphic queue family does
+         * the transfers.
+         * @param commandList A GRAPHIC command list
+         */
+        void acquire(const CommandList& commandList);
+
+        /**
+         * Blocks the calling thread until all the queued loads are read and their copies are finished
+         */
+        void wait();
+
+        /**
+         * Returns the timeline semaphore signaled by the copies. Once poll() returns `true`, wait for its current
+         * value before using the loaded resources on another queue.
+         */
+        auto getSemaphore() const { return semaphore; }
+
+        /**
+         * Returns the size in bytes of a staging slice
+         */
+        auto getSliceSize() const { return sliceSize; }
+
+        StreamingLoader(const Vireo& vireo, size_t sliceSize, uint32_t sliceCount, const std::wstring& name);
+        ~StreamingLoader();
+        StreamingLoader (const StreamingLoader&) = delete;
+        StreamingLoader& operator = (const StreamingLoader&) = delete;
+
+    private:
+        // Range or level released to the graphic queue family, acquired by acquire()
+        struct Release {
+            const Buffer* buffer{nullptr};
+            size_t        offset{0};
+            size_t        size{0};
+            const Image*  image{nullptr};
+            uint32_t      mipLevel{0};
+            uint32_t      arrayLayer{0};
+        };
+
+        // Queued load of a buffer range or of an image level
+        struct Request {
+            std::filesystem::path file;
+            size_t                fileOffset{0};
+            // Bytes of a buffer range or rows of an image level
+            size_t                size{0};
+            const Buffer*         buffer{nullptr};
+            size_t                destinationOffset{0};
+            const Image*          image{nullptr};
+            ImageRegion           level{};
+            size_t                rowPitch{0};
+            size_t                alignedRowPitch{0};
+            uint32_t              blockHeight{1};
+            // Rows copied from one slice
+            uint32_t              sliceRowCount{0};
+        };
+
+        struct Slice {
+            std::shared_ptr<Buffer>           buffer;
+            std::shared_ptr<CommandAllocator> commandAllocator;
+            std::shared_ptr<CommandList>      commandList;
+            // Semaphore value signaled when the copy from the slice is finished
+            uint64_t                          value{0};
+            // A read of the current request is in flight in the slice
+            bool                              reading{false};
+            // Leading bytes of an unbuffered read skipped by the copy
+            size_t                            skew{0};
+            // First byte or row of the request read in the slice
+            size_t                            first{0};
+            // Bytes or rows read in the slice
+            size_t                            count{0};
+        };
+
+        // Drops the current request when poll() or wait() throws
+        struct FailureGuard {
+            StreamingLoader& loader;
+            const int        exceptions{std::uncaught_exceptions()};
+            ~FailureGuard();
+        };
+
+        const size_t                     sliceSize;
+        // Reads the files, the io_uring is created once per loader
+        std::unique_ptr<AsyncFileReader> reader;
+        std::shared_ptr<SubmitQueue>     transferQueue;
+        std::shared_ptr<Semaphore>       semaphore;
+        std::vector<Slice>               slices;
+        std::vector<Release>             releases;
+        // The slices are aligned for the unbuffered reads
+        bool                             direct{false};
+        std::deque<Request>              requests;
+        // The file of the current request is opened in the reader
+        bool                             opened{false};
+        // Bytes or rows of the current request read or being read
+        size_t                           requested{0};
+        // Bytes or rows of the current request copied
+        size_t                           copied{0};
+        uint32_t                         readCount{0};
+
+        // Queues the reads of the current request in the slices not being read and already copied by the GPU
+        void readChunks(const Request& request);
+
+        // Records and submits the copy of a chunk read in a slice
+        void copyChunk(uint32_t index, size_t readSize);
+
+        // Drops the current request and waits for its reads in flight
+        void abortRequest() noexcept;
+
+        // Starts recording the copy from a slice
+        void beginSlice(const Slice& slice) const;
+
+        // Submits the copy recorded for a slice
+        void submitSlice(Slice& slice);
+    };
+
+    /**
+     * Recycles command lists for the threads recording commands in parallel.
+     * Each thread acquiring a command list gets its own command allocator per frame in flight, created on the first
+     * acquisition, so the threads never share an allocator. The command lists are kept from frame to frame :
+     * once a frame has been recorded once, acquiring its command lists does not allocate anything.
+     * acquire() can be called from any thread, but never concurrently with reset().
+     * A thread that stops recording releases its command allocators with releaseThread().
+     *
+     * Manual page : \ref manual_050_00_commands
+     */
+    class CommandListPool {
+    public:
+        /**
+         * Starts a frame : waits for the fence of the frame then resets the command allocators of all the threads
+         * for this frame and makes their command lists available again.
+         * SwapChain::acquire() resets the fence, call this function before it.
+         * @param frameIndex Index of the frame in flight
+         * @param fence Fence signaled when the GPU has finished the previous commands of this frame
+         */
+        void reset(uint32_t frameIndex, const Fence& fence);
+
+        /**
+         * Destroys the command allocators and the command lists of the calling thread, for example before the
+         * thread exits. The GPU must have finished the commands recorded by the thread. A thread acquiring
+         * command lists again gets new command allocators.
+         */
+        void releaseThread();
+
+        /**
+         * Returns a command list of the calling thread for the current frame. The command list is not
+         * recording, call CommandList::begin() before recording the commands.
+         */
+        std::shared_ptr<CommandList> acquire();
+
+        /**
+         * Returns a secondary command list of the calling thread for the current frame, for the GRAPHIC pools.
+         * Call CommandList::begin(const RenderingConfiguration&, CommandListUsage) before recording the commands.
+         */
+        std::shared_ptr<CommandList> acquireSecondary();
+
+        /**
+         * Returns the type of the command lists
+         */
+        auto getCommandListType() const { return type; }
+
+        /**
+         * Returns the number of frames in flight
+         */
+        auto getFramesInFlight() const { return framesInFlight; }
+
+        CommandListPool(const Vireo& vireo, CommandType type, uint32_t framesInFlight);
+        CommandListPool (const CommandListPool&) = delete;
+        CommandListPool& operator = (const CommandListPool&) = delete;
+
+    private:
+        struct Frame {
+            std::shared_ptr<CommandAllocator>         commandAllocator;
+            std::vector<std::shared_ptr<CommandList>> commandLists;
+            std::vector<std::shared_ptr<CommandList>> secondaryCommandLists;
+            // Number of command lists acquired since the last reset
+            uint32_t                                  used{0};
+            uint32_t                                  usedSecondary{0};
+        };
+
+        // Command allocators of a thread, indexed by frame
+        struct ThreadPool {
+            std::vector<Frame> frames;
+        };
+
+        // Last pool used by a thread, avoids the lock while a thread records with a single pool
+        struct ThreadCache {
+            uint64_t    poolId{0};
+            ThreadPool* threadPool{nullptr};
+        };
+
+        const Vireo&       vireo;
+        const CommandType  type;
+        const uint32_t     framesInFlight;
+        // Identifies the pool in the per-thread cache, the addresses can be reused
+        const uint64_t     id;
+        uint32_t           currentFrame{0};
+        std::unordered_map<std::thread::id, std::unique_ptr<ThreadPool>> threads;
+        std::mutex         mutex;
+
+        // Returns the command allocators of the calling thread, creating them on the first call
+        ThreadPool& getThreadPool();
+
+        // Cache of the calling thread
+        static ThreadCache& getThreadCache();
+    };
+
     /**
      * Main abstraction class.
      *
@@ -2541,6 +3488,75 @@ export namespace vireo {
 
         virtual void waitIdle() {}
 
+        /**
+         * Defers the destruction of the GPU objects of the buffers, images and memory heaps.
+         * When the last reference to a resource is dropped the GPU objects are queued and destroyed by collect()
+         * once the frames that may use them are finished, so resources can be released without waiting for the GPU.
+         * Not supported by the DirectX backend, the resources are always released immediately.
+         * @param framesInFlight Number of calls to collect() before destroying the objects, 0 to destroy the objects
+         * immediately.
+         */
+        virtual void setDeferredDestruction(uint32_t framesInFlight) {}
+
+        /**
+         * Ends a frame for the deferred destruction and destroys the retired GPU objects.
+         * Must be called once per frame after waiting for the fence of the frame.
+         */
+        virtual void collect() {}
+
+        /**
+         * Returns the usage and the budget of the device memory heaps.
+         * Cheap enough to be called every frame.
+         */
+        virtual VideoMemoryBudget getMemoryBudget() const { return {}; }
+
+        /**
+         * Returns the usage and the fragmentation of the device memory blocks the resources are sub-allocated from.
+         * Not supported by the DirectX backend, the committed resources are allocated by the driver and the
+         * statistics are always empty.
+         */
+        virtual VideoMemoryStatistics getMemoryStatistics() const { return {}; }
+
+        /**
+         * Returns `true` if the images created with ImageUsage::HOST_TRANSFER can be uploaded from the host
+         * with upload(), without staging buffer nor command list
+         */
+        virtual bool isHostImageCopySupported() const { return false; }
+
+        /**
+         * Copies data from the host memory into a level of an image, without staging buffer nor command list.
+         * The image must have been created with ImageUsage::HOST_TRANSFER and must not be used by the GPU during the
+         * copy. It is left in the ResourceState::SHADER_READ state.
+         * Can be called from any thread, concurrent uploads into the same image must be synchronized by the caller.
+         * Throws an Exception if isHostImageCopySupported() returns `false`.
+         * @param destination Destination image
+         * @param source Source data for all the layers of the level, with packed rows
+         * @param mipLevel Level to upload
+         */
+        virtual void upload(const Image& destination, const void* source, uint32_t mipLevel = 0) const;
+
+        /**
+         * Returns the alignment of the addresses and sizes accepted by importHostBuffer(),
+         * 0 if the device can't use host memory for buffers
+         */
+        virtual size_t getHostImportAlignment() const { return 0; }
+
+        /**
+         * Creates a buffer using existing host memory (page-aligned allocations, memory-mapped files, shared memory
+         * segments) without copying it : the GPU reads and writes the host pages directly.
+         * The host memory must stay valid until the buffer is destroyed, deferred destruction included.
+         * Throws an Exception if getHostImportAlignment() returns 0.
+         * @param address Host address, aligned on getHostImportAlignment()
+         * @param size Size in bytes, multiple of getHostImportAlignment()
+         * @param type Type of buffer : UNIFORM, STORAGE or one of the UPLOAD & DOWNLOAD types
+         * @param name Object name for debug
+         */
+        virtual std::shared_ptr<Buffer> importHostBuffer(
+            void* address,
+            size_t size,
+            BufferType type,
+            const std::wstring& name = L"HostBuffer") const;
+
         /**
          * Creates a swap chain.
          * @param format            Color format of the swap chain images
@@ -2583,6 +3599,38 @@ export namespace vireo {
             SemaphoreType type,
             const std::wstring& name = L"Semaphore") const = 0;
 
+        /**
+         * Creates a ring of persistently mapped host memory for the asynchronous GPU to host copies,
+         * with its own timeline semaphore.
+         * @param size Size of the ring in bytes
+         * @param name Object name for debug
+         */
+        std::shared_ptr<ReadbackRing> createReadbackRing(
+            size_t size = ReadbackRing::DEFAULT_SIZE,
+            const std::wstring& name = L"ReadbackRing") const;
+
+        /**
+         * Creates a loader streaming files content into buffers and images, with its own transfer queue,
+         * staging slices and timeline semaphore.
+         * @param sliceSize Size in bytes of a staging slice, the maximum size of a copy
+         * @param sliceCount Number of staging slices, the number of copies in flight
+         * @param name Object name for debug
+         */
+        std::shared_ptr<StreamingLoader> createStreamingLoader(
+            size_t sliceSize = StreamingLoader::DEFAULT_SLICE_SIZE,
+            uint32_t sliceCount = StreamingLoader::DEFAULT_SLICE_COUNT,
+            const std::wstring& name = L"StreamingLoader") const;
+
+        /**
+         * Creates a pool of recycled command lists for the threads recording commands in parallel.
+         * The pool must not outlive this object.
+         * @param type Type of commands that will be used with the command lists
+         * @param framesInFlight Number of frames in flight, each one with its own command allocators
+         */
+        std::shared_ptr<CommandListPool> createCommandListPool(
+            CommandType type,
+            uint32_t framesInFlight = 2) const;
+
         /**
          * Creates a command allocator (command pool) for a given command type
          * @param type Type of commands that will be used with command lists created from this allocator
@@ -2666,6 +3714,41 @@ export namespace vireo {
             size_t count = 1,
             const std::wstring& name = L"Buffer") const = 0;
 
+        /**
+         * Creates a data buffer in VRAM with additional usages.
+         * The memory type is selected by the buffer type and the additional usages
+         * are combined with the usage implied by the type.
+         * @param type Type of buffer to create.
+         * @param usage Additional usages of the buffer
+         * @param size Size of one element in bytes
+         * @param count Number of elements
+         * @param name Object name for debug
+         */
+        virtual std::shared_ptr<Buffer> createBuffer(
+            BufferType type,
+            BufferUsage usage,
+            size_t size,
+            size_t count = 1,
+            const std::wstring& name = L"Buffer") const = 0;
+
+        /**
+         * Creates a persistently mapped UNIFORM or STORAGE buffer in host visible memory/upload heap type.
+         * The buffer holds `versionCount` copies of its content, use Buffer::discard() before writing a new content
+         * and Buffer::getCurrentOffset() when binding or copying the buffer.
+         * @param type Type of buffer to create, UNIFORM or STORAGE
+         * @param size Size of one element in bytes
+         * @param count Number of elements
+         * @param versionCount Number of copies of the content, usually the number of frames in flight. Only UNIFORM
+         * buffers, bound with a UNIFORM_DYNAMIC descriptor and the current offset, can have more than one version.
+         * @param name Object name for debug
+         */
+        virtual std::shared_ptr<Buffer> createMappedBuffer(
+            BufferType type,
+            size_t size,
+            size_t count = 1,
+            uint32_t versionCount = 1,
+            const std::wstring& name = L"MappedBuffer") const = 0;
+
         /**
          * Creates a read-only image in VRAM
          * @param format Pixel format
@@ -2674,6 +3757,8 @@ export namespace vireo {
          * @param mipLevels Number of mips levels
          * @param arraySize Number of layers/array size
          * @param name Object name for debug
+         * @param usage Minimal set of usages, ImageUsage::DEFAULT for transfers and sampling.
+         * An image with the ImageUsage::STORAGE usage have read/write access.
          */
         virtual std::shared_ptr<Image> createImage(
             ImageFormat format,
@@ -2681,7 +3766,8 @@ export namespace vireo {
             uint32_t height,
             uint32_t mipLevels = 1,
             uint32_t arraySize = 1,
-            const std::wstring& name = L"Image") const = 0;
+            const std::wstring& name = L"Image",
+            ImageUsage usage = ImageUsage::DEFAULT) const = 0;
 
         /**
          * Creates a read/write image in VRAM
@@ -2709,6 +3795,8 @@ export namespace vireo {
          * @param clearValue A clear value used for optimized clearing. Must be the same as the clear value used when rendering.
          * @param msaa Number of samples for MSAA. A value of 1 disables MSAA.
          * @param name Object name for debug
+         * @param usage Minimal set of usages in addition to ImageUsage::ATTACHMENT, ImageUsage::DEFAULT for
+         * transfers and sampling.
          */
         virtual std::shared_ptr<RenderTarget> createRenderTarget(
             ImageFormat format,
@@ -2717,7 +3805,8 @@ export namespace vireo {
             RenderTargetType type = RenderTargetType::COLOR,
             ClearValue clearValue = {},
             MSAA msaa = MSAA::NONE,
-            const std::wstring& name = L"RenderTarget") const = 0;
+            const std::wstring& name = L"RenderTarget",
+            ImageUsage usage = ImageUsage::DEFAULT) const = 0;
 
         /**
          * Creates a read/write image in VRAM for use as a render target with a similar format as a swap chain.
@@ -2726,12 +3815,96 @@ export namespace vireo {
          * rendering.
          * @param msaa Number of samples for MSAA. A value of 1 disables MSAA.
          * @param name Object name for debug
+         * @param usage Minimal set of usages in addition to ImageUsage::ATTACHMENT, ImageUsage::DEFAULT for
+         * transfers and sampling.
          */
         virtual std::shared_ptr<RenderTarget> createRenderTarget(
             const std::shared_ptr<const SwapChain>& swapChain,
             ClearValue clearValue = {},
             MSAA msaa = MSAA::NONE,
-            const std::wstring& name = L"RenderTarget") const = 0;
+            const std::wstring& name = L"RenderTarget",
+            ImageUsage usage = ImageUsage::DEFAULT) const = 0;
+
+        /**
+         * Creates a memory heap in VRAM for placed resources
+         * @param size Size of the heap in bytes
+         * @param name Object name for debug
+         * @param usage Class of the resources placed in the heap, MemoryHeapUsage::ALL needs a DirectX device with
+         * resource heap tier 2
+         */
+        virtual std::shared_ptr<MemoryHeap> createMemoryHeap(
+            size_t size,
+            const std::wstring& name = L"MemoryHeap",
+            MemoryHeapUsage usage = MemoryHeapUsage::ALL) const = 0;
+
+        /**
+         * Creates a data buffer at an offset of a memory heap.
+         * Only the types stored in GPU memory can be placed : VERTEX, INDEX, INDIRECT, DEVICE_STORAGE and
+         * READWRITE_STORAGE.
+         * @param heap Memory heap to place the buffer in
+         * @param offset Offset in bytes in the heap, multiple of MemoryHeap::PLACEMENT_ALIGNMENT
+         * @param type Type of buffer to create.
+         * @param size Size of one element in bytes
+         * @param count Number of elements
+         * @param name Object name for debug
+         */
+        virtual std::shared_ptr<Buffer> createPlacedBuffer(
+            const std::shared_ptr<const MemoryHeap>& heap,
+            size_t offset,
+            BufferType type,
+            size_t size,
+            size_t count = 1,
+            const std::wstring& name = L"PlacedBuffer") const = 0;
+
+        /**
+         * Creates an image at an offset of a memory heap
+         * @param heap Memory heap to place the image in
+         * @param offset Offset in bytes in the heap, multiple of MemoryHeap::PLACEMENT_ALIGNMENT
+         * @param format Pixel format
+         * @param width With in pixels
+         * @param height Height in pixels
+         * @param mipLevels Number of mips levels
+         * @param arraySize Number of layers/array size
+         * @param name Object name for debug
+         * @param usage Minimal set of usages, ImageUsage::DEFAULT for transfers and sampling.
+         */
+        virtual std::shared_ptr<Image> createPlacedImage(
+            const std::shared_ptr<const MemoryHeap>& heap,
+            size_t offset,
+            ImageFormat format,
+            uint32_t width,
+            uint32_t height,
+            uint32_t mipLevels = 1,
+            uint32_t arraySize = 1,
+            const std::wstring& name = L"PlacedImage",
+            ImageUsage usage = ImageUsage::DEFAULT) const = 0;
+
+        /**
+         * Creates a render target at an offset of a memory heap
+         * @param heap Memory heap to place the render target in
+         * @param offset Offset in bytes in the heap, multiple of MemoryHeap::PLACEMENT_ALIGNMENT, or of
+         * MemoryHeap::MSAA_PLACEMENT_ALIGNMENT for MSAA render targets
+         * @param format Pixel format
+         * @param width With in pixels
+         * @param height Height in pixels
+         * @param type Type of render target use
+         * @param clearValue A clear value used for optimized clearing. Must be the same as the clear value used when rendering.
+         * @param msaa Number of samples for MSAA. A value of 1 disables MSAA.
+         * @param name Object name for debug
+         * @param usage Minimal set of usages in addition to ImageUsage::ATTACHMENT, ImageUsage::DEFAULT for
+         * transfers and sampling.
+         */
+        virtual std::shared_ptr<RenderTarget> createPlacedRenderTarget(
+            const std::shared_ptr<const MemoryHeap>& heap,
+            size_t offset,
+            ImageFormat format,
+            uint32_t width,
+            uint32_t height,
+            RenderTargetType type = RenderTargetType::COLOR,
+            ClearValue clearValue = {},
+            MSAA msaa = MSAA::NONE,
+            const std::wstring& name = L"PlacedRenderTarget",
+            ImageUsage usage = ImageUsage::DEFAULT) const = 0;
 
         /**
          * Creates an empty description layout.
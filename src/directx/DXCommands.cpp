@@ -151,10 +151,18 @@ namespace vireo {
         dxCheck(device->CreateCommandAllocator(
             DXCommandList::dxType[static_cast<int>(type)],
             IID_PPV_ARGS(&commandAllocator)));
+        if (type == CommandType::GRAPHIC) {
+            dxCheck(device->CreateCommandAllocator(
+                D3D12_COMMAND_LIST_TYPE_BUNDLE,
+                IID_PPV_ARGS(&bundleAllocator)));
+        }
     }
 
     void DXCommandAllocator::reset() const {
         dxCheck(commandAllocator->Reset());
+        if (bundleAllocator) {
+            dxCheck(bundleAllocator->Reset());
+        }
     }
 
     std::shared_ptr<CommandList> DXCommandAllocator::createCommandList(const Pipeline& pipeline) const {
@@ -175,18 +183,31 @@ namespace vireo {
             nullptr);
     }
 
+    std::shared_ptr<CommandList> DXCommandAllocator::createSecondaryCommandList() const {
+        assert(bundleAllocator != nullptr);
+        return std::make_shared<DXCommandList>(
+            getCommandListType(),
+            device,
+            bundleAllocator,
+            descriptorHeaps,
+            nullptr,
+            true);
+    }
+
     DXCommandList::DXCommandList(
         const CommandType type,
         const ComPtr<ID3D12Device>& device,
         const ComPtr<ID3D12CommandAllocator>& commandAllocator,
         const std::vector<std::shared_ptr<DXDescriptorHeap>>& descriptorHeaps,
-        const ComPtr<ID3D12PipelineState>& pipelineState):
+        const ComPtr<ID3D12PipelineState>& pipelineState,
+        const bool bundle):
         device{device},
+        bundle{bundle},
         commandAllocator{commandAllocator},
         descriptorHeaps{descriptorHeaps} {
         dxCheck(device->CreateCommandList(
             0,
-            dxType[static_cast<int>(type)],
+            bundle ? D3D12_COMMAND_LIST_TYPE_BUNDLE : dxType[static_cast<int>(type)],
             commandAllocator.Get(),
             pipelineState == nullptr ? nullptr : pipelineState.Get(),
             IID_PPV_ARGS(&commandList)));
@@ -256,6 +277,8 @@ namespace vireo {
     }
 
     void DXCommandList::setViewports(const std::vector<Viewport>& viewports) const {
+        // Bundles use the viewports of the executing command list
+        if (bundle) { return; }
         std::vector<CD3DX12_VIEWPORT> dxViewports(viewports.size());
         for (int i = 0; i < viewports.size(); i++) {
             dxViewports[i].TopLeftX = viewports[i].x;
@@ -269,6 +292,7 @@ namespace vireo {
     }
 
     void DXCommandList::setScissors(const std::vector<Rect>& rects) const {
+        if (bundle) { return; }
         std::vector<CD3DX12_RECT> scissors(rects.size());
         for (int i = 0; i < scissors.size(); i++) {
             scissors[i].left = rects[i].x;
@@ -280,6 +304,7 @@ namespace vireo {
     }
 
     void DXCommandList::setViewport(const Viewport& viewport) const {
+        if (bundle) { return; }
         const auto dxViewport = D3D12_VIEWPORT{
             .TopLeftX = viewport.x,
             .TopLeftY = viewport.y,
@@ -292,6 +317,7 @@ namespace vireo {
     }
 
     void DXCommandList::setScissors(const Rect& rect) const {
+        if (bundle) { return; }
         const auto scissor = D3D12_RECT{
             .left = rect.x,
             .top = rect.y,
@@ -423,6 +449,15 @@ namespace vireo {
         colorTargetsToDiscard.clear();
     }
 
+    void DXCommandList::executeCommands(const std::vector<std::shared_ptr<const CommandList>>& commandLists) {
+        assert(!bundle);
+        assert(!commandLists.empty());
+        for (const auto& bundleList : commandLists) {
+            commandList->ExecuteBundle(static_pointer_cast<const DXCommandList>(bundleList)->getCommandList().Get());
+        }
+        currentlyBoundPipeline = nullptr;
+    }
+
     void DXCommandList::dispatch(const uint32_t x, const uint32_t y, const uint32_t z) const {
         commandList->Dispatch(x, y, z);
     }
@@ -441,6 +476,25 @@ namespace vireo {
             image->getArraySize());
     }
 
+    void DXCommandList::barrier(
+        const std::shared_ptr<const Image>& before,
+        const std::shared_ptr<const Image>& after) const {
+        assert(after != nullptr);
+        const auto barrier = CD3DX12_RESOURCE_BARRIER::Aliasing(
+            before ? static_pointer_cast<const DXImage>(before)->getImage().Get() : nullptr,
+            static_pointer_cast<const DXImage>(after)->getImage().Get());
+        commandList->ResourceBarrier(1, &barrier);
+    }
+
+    void DXCommandList::barrier(
+        const Buffer& before,
+        const Buffer& after) const {
+        const auto barrier = CD3DX12_RESOURCE_BARRIER::Aliasing(
+            static_cast<const DXBuffer&>(before).getBuffer().Get(),
+            static_cast<const DXBuffer&>(after).getBuffer().Get());
+        commandList->ResourceBarrier(1, &barrier);
+    }
+
     void DXCommandList::barrier(
         const std::shared_ptr<const SwapChain>& swapChain,
         const ResourceState oldState,
@@ -719,10 +773,17 @@ namespace vireo {
             pushConstants.offset);
     }
 
-    void DXCommandList::begin() const {
+    void DXCommandList::begin(CommandListUsage) const {
+        // Closed command lists can always be executed again, even while in flight
         dxCheck(commandList->Reset(commandAllocator.Get(), nullptr));
     }
 
+    void DXCommandList::begin(const RenderingConfiguration&, const CommandListUsage usage) const {
+        assert(bundle);
+        // Bundles inherit the render targets of the executing command list
+        begin(usage);
+    }
+
     void DXCommandList::end() const {
         dxCheck(commandList->Close());
     }
@@ -740,7 +801,7 @@ namespace vireo {
             const auto offset = offsets.empty() ? 0 : offsets[i];
             bufferViews[i] = D3D12_VERTEX_BUFFER_VIEW {
                 .BufferLocation = vertexBuffer->getBuffer().Get()->GetGPUVirtualAddress() + offset,
-                .SizeInBytes = static_cast<UINT>(vertexBuffer->getSize() - offset),
+                .SizeInBytes = getViewSize(vertexBuffer->getSize() - offset),
                 .StrideInBytes = static_cast<UINT>(vertexBuffer->getStride()),
             };
         }
@@ -751,7 +812,7 @@ namespace vireo {
         const auto& vertexBuffer = static_cast<const DXBuffer&>(buffer);
         const auto bufferView = D3D12_VERTEX_BUFFER_VIEW {
             .BufferLocation = vertexBuffer.getBuffer().Get()->GetGPUVirtualAddress() + offset,
-            .SizeInBytes = static_cast<UINT>(vertexBuffer.getSize() - offset),
+            .SizeInBytes = getViewSize(vertexBuffer.getSize() - offset),
             .StrideInBytes = static_cast<UINT>(vertexBuffer.getStride()),
         };
         commandList->IASetVertexBuffers(0, 1, &bufferView);
@@ -759,10 +820,10 @@ namespace vireo {
 
     void DXCommandList::bindIndexBuffer(const Buffer& buffer, IndexType indexType, const uint32_t firstIndex) const {
         const auto& indexBuffer = static_cast<const DXBuffer&>(buffer);
-        const auto offset = firstIndex * indexTypeSize[static_cast<int>(indexType)];
+        const auto offset = UINT64{firstIndex} * indexTypeSize[static_cast<int>(indexType)];
         const auto bufferView = D3D12_INDEX_BUFFER_VIEW {
             .BufferLocation = indexBuffer.getBuffer().Get()->GetGPUVirtualAddress() + offset,
-            .SizeInBytes = static_cast<UINT>(indexBuffer.getSize() - offset),
+            .SizeInBytes = getViewSize(indexBuffer.getSize() - offset),
             .Format = dxIndexType[static_cast<int>(indexType)]
         };
         commandList->IASetIndexBuffer(&bufferView);
@@ -927,12 +988,93 @@ namespace vireo {
         stagingBuffers.push_back(stagingBuffer);
     }
 
+    void DXCommandList::upload(
+        const Buffer& destination,
+        const void* source,
+        const size_t size,
+        const size_t offset) {
+        assert(source != nullptr);
+        assert(destination.getSize() >= (offset + size));
+        if (size == 0) { return; }
+        const auto& buffer = static_cast<const DXBuffer&>(destination);
+        void* mappedAddress;
+        const auto stagingBuffer = createStagingBuffer(size, &mappedAddress, L"stagingBuffer buffer range");
+        memcpy(mappedAddress, source, size);
+        stagingBuffer->Unmap(0, nullptr);
+        commandList->CopyBufferRegion(
+            buffer.getBuffer().Get(),
+            offset,
+            stagingBuffer.Get(),
+            0,
+            size);
+        stagingBuffers.push_back(stagingBuffer);
+    }
+
+    void DXCommandList::upload(
+        const Buffer& destination,
+        const void* source,
+        const std::vector<BufferInstanceRange>& ranges) {
+        assert(source != nullptr);
+        const auto& buffer = static_cast<const DXBuffer&>(destination);
+        const auto mergedRanges = mergeInstanceRanges(ranges);
+        if (mergedRanges.empty()) { return; }
+        assert(mergedRanges.back().firstInstance + mergedRanges.back().instanceCount <= buffer.getInstanceCount());
+
+        // The instances are staged with the same alignment as in the destination buffer
+        size_t stagingSize{0};
+        for (const auto& range : mergedRanges) {
+            stagingSize += size_t{range.instanceCount} * buffer.getInstanceSizeAligned();
+        }
+        void* mappedAddress;
+        const auto stagingBuffer = createStagingBuffer(stagingSize, &mappedAddress, L"stagingBuffer buffer instances");
+        size_t stagingOffset{0};
+        for (const auto& range : mergedRanges) {
+            for (uint32_t i = 0; i < range.instanceCount; i++) {
+                memcpy(
+                    static_cast<std::byte*>(mappedAddress) + stagingOffset + size_t{i} * buffer.getInstanceSizeAligned(),
+                    static_cast<const std::byte*>(source) + size_t{range.firstInstance + i} * buffer.getInstanceSize(),
+                    buffer.getInstanceSize());
+            }
+            commandList->CopyBufferRegion(
+                buffer.getBuffer().Get(),
+                UINT64{range.firstInstance} * buffer.getInstanceSizeAligned(),
+                stagingBuffer.Get(),
+                stagingOffset,
+                UINT64{range.instanceCount - 1} * buffer.getInstanceSizeAligned() + buffer.getInstanceSize());
+            stagingOffset += size_t{range.instanceCount} * buffer.getInstanceSizeAligned();
+        }
+        stagingBuffer->Unmap(0, nullptr);
+        stagingBuffers.push_back(stagingBuffer);
+    }
+
+    ComPtr<ID3D12Resource> DXCommandList::createStagingBuffer(
+        const size_t size,
+        void** mappedAddress,
+        const std::wstring& name) {
+        ComPtr<ID3D12Resource> stagingBuffer;
+        const auto stagingHeapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+        const auto stagingResourceDesc = CD3DX12_RESOURCE_DESC::Buffer(size);
+        dxCheck(device->CreateCommittedResource(
+            &stagingHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &stagingResourceDesc,
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&stagingBuffer)));
+#ifdef _DEBUG
+        stagingBuffer->SetName(name.c_str());
+#endif
+        const CD3DX12_RANGE readRange(0, 0);
+        dxCheck(stagingBuffer->Map(0, &readRange, mappedAddress));
+        return stagingBuffer;
+    }
+
     void DXCommandList::copy(
         const Buffer& source,
         const Buffer& destination,
         const size_t size,
-        const uint32_t sourceOffset,
-        const uint32_t destinationOffset) const {
+        const size_t sourceOffset,
+        const size_t destinationOffset) const {
         const auto copySize = size == Buffer::WHOLE_SIZE ? min(source.getSize(), destination.getSize()) : size;
         assert(source.getSize() >= (copySize + sourceOffset));
         assert(destination.getSize() >= (copySize + destinationOffset));
@@ -1033,7 +1175,7 @@ namespace vireo {
     void DXCommandList::copy(
         const Buffer& source,
         const Image& destination,
-        const uint32_t sourceOffset,
+        const size_t sourceOffset,
         const uint32_t firstMipLevel,
         const bool rowPitchAlignment) const {
         const auto& image = static_cast<const DXImage&>(destination);
@@ -1078,6 +1220,78 @@ namespace vireo {
         );
     }
 
+    void DXCommandList::upload(
+        const Image& destination,
+        const void* source,
+        const ImageRegion& region) {
+        assert(source != nullptr);
+        // The rows are packed in the source and aligned in the staging buffer
+        const auto rowPitch = destination.getRowPitch(region);
+        const auto alignedRowPitch = destination.getAlignedRowPitch(region);
+        const auto rowCount = destination.getRowCount(region);
+        void* mappedAddress;
+        const auto stagingBuffer = createStagingBuffer(
+            static_cast<size_t>(alignedRowPitch) * rowCount,
+            &mappedAddress,
+            L"stagingBuffer image region");
+        for (uint32_t row = 0; row < rowCount; row++) {
+            memcpy(
+                static_cast<std::byte*>(mappedAddress) + static_cast<size_t>(row) * alignedRowPitch,
+                static_cast<const std::byte*>(source) + static_cast<size_t>(row) * rowPitch,
+                rowPitch);
+        }
+        stagingBuffer->Unmap(0, nullptr);
+        copyToRegion(stagingBuffer.Get(), 0, destination, region);
+        stagingBuffers.push_back(stagingBuffer);
+    }
+
+    void DXCommandList::copy(
+        const Buffer& source,
+        const Image& destination,
+        const ImageRegion& region,
+        const size_t sourceOffset) const {
+        copyToRegion(static_cast<const DXBuffer&>(source).getBuffer().Get(), sourceOffset, destination, region);
+    }
+
+    void DXCommandList::copyToRegion(
+        ID3D12Resource* buffer,
+        const UINT64 offset,
+        const Image& destination,
+        const ImageRegion& region) const {
+        assert(region.mipLevel < destination.getMipLevels());
+        assert(region.arrayLayer < destination.getArraySize());
+        assert(region.width > 0 && region.height > 0);
+        assert(region.x + region.width <= std::max(1u, destination.getWidth() >> region.mipLevel));
+        assert(region.y + region.height <= std::max(1u, destination.getHeight() >> region.mipLevel));
+        assert(offset % D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT == 0);
+        const auto& image = static_cast<const DXImage&>(destination);
+        auto dstLocation = D3D12_TEXTURE_COPY_LOCATION{
+            .pResource = image.getImage().Get(),
+            .Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX,
+        };
+        dstLocation.SubresourceIndex = D3D12CalcSubresource(
+            region.mipLevel,
+            region.arrayLayer,
+            0,
+            image.getMipLevels(),
+            image.getArraySize());
+        const auto srcLocation = D3D12_TEXTURE_COPY_LOCATION{
+            .pResource = buffer,
+            .Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT,
+            .PlacedFootprint = {
+                .Offset = offset,
+                .Footprint = {
+                    .Format = image.getImage()->GetDesc().Format,
+                    .Width = region.width,
+                    .Height = region.height,
+                    .Depth = 1,
+                    .RowPitch = image.getAlignedRowPitch(region),
+                },
+            },
+        };
+        commandList->CopyTextureRegion(&dstLocation, region.x, region.y, 0, &srcLocation, nullptr);
+    }
+
     void DXCommandList::copy(
         const Buffer& source,
         const Image& destination,
@@ -1123,7 +1337,7 @@ namespace vireo {
     void DXCommandList::copy(
         const Image& source,
         const Buffer& destination,
-        const uint32_t destinationOffset,
+        const size_t destinationOffset,
         const uint32_t firstMipLevel) const {
         const auto& image = static_cast<const DXImage&>(source);
         const auto& buffer = static_cast<const DXBuffer&>(destination);
@@ -1263,6 +1477,22 @@ namespace vireo {
         if (type == SemaphoreType::BINARY) {
             incrementValue();
         }
+        fenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    }
+
+    uint64_t DXSemaphore::getCompletedValue() const {
+        return fence->GetCompletedValue();
+    }
+
+    void DXSemaphore::wait(const uint64_t value) const {
+        if (fence->GetCompletedValue() < value) {
+            dxCheck(fence->SetEventOnCompletion(value, fenceEvent));
+            WaitForSingleObject(fenceEvent, INFINITE);
+        }
+    }
+
+    DXSemaphore::~DXSemaphore() {
+        CloseHandle(fenceEvent);
     }
 
 }
@@ -43,8 +43,15 @@ export namespace vireo {
 
         auto getFence() const { return fence; }
 
+        uint64_t getCompletedValue() const override;
+
+        void wait(uint64_t value) const override;
+
+        ~DXSemaphore() override;
+
     private:
         ComPtr<ID3D12Fence> fence;
+        HANDLE              fenceEvent;
     };
 
     class DXSubmitQueue : public SubmitQueue{
@@ -112,9 +119,13 @@ export namespace vireo {
 
         std::shared_ptr<CommandList> createCommandList() const override;
 
+        std::shared_ptr<CommandList> createSecondaryCommandList() const override;
+
     private:
         ComPtr<ID3D12Device>           device;
         ComPtr<ID3D12CommandAllocator> commandAllocator;
+        // Allocator of the bundles, only for the GRAPHIC type
+        ComPtr<ID3D12CommandAllocator> bundleAllocator;
         //List of current heaps to pass to the command lists
         std::vector<std::shared_ptr<DXDescriptorHeap>> descriptorHeaps;
     };
@@ -137,11 +148,16 @@ export namespace vireo {
             const ComPtr<ID3D12Device>& device,
             const ComPtr<ID3D12CommandAllocator>& commandAllocator,
             const std::vector<std::shared_ptr<DXDescriptorHeap>>& descriptorHeaps,
-            const ComPtr<ID3D12PipelineState>& pipelineState = nullptr);
+            const ComPtr<ID3D12PipelineState>& pipelineState = nullptr,
+            bool bundle = false);
 
         ~DXCommandList() override;
 
-        void begin() const override;
+        void begin(CommandListUsage usage = CommandListUsage::DEFAULT) const override;
+
+        void begin(
+            const RenderingConfiguration& conf,
+            CommandListUsage usage = CommandListUsage::DEFAULT) const override;
 
         void end() const override;
 
@@ -149,18 +165,40 @@ export namespace vireo {
             const Buffer& destination,
             const void* source) override;
 
+        void upload(
+            const Buffer& destination,
+            const void* source,
+            size_t size,
+            size_t offset) override;
+
+        void upload(
+            const Buffer& destination,
+            const void* source,
+            const std::vector<BufferInstanceRange>& ranges) override;
+
         void upload(
             const Image& destination,
             const void* source,
             uint32_t firstMipLevel) override;
 
+        void upload(
+            const Image& destination,
+            const void* source,
+            const ImageRegion& region) override;
+
         void copy(
             const Buffer& source,
             const Image& destination,
-            uint32_t sourceOffset,
+            size_t sourceOffset,
             uint32_t firstMipLevel,
             bool) const override;
 
+        void copy(
+            const Buffer& source,
+            const Image& destination,
+            const ImageRegion& region,
+            size_t sourceOffset) const override;
+
         void copy(
             const Buffer& source,
             const Image& destination,
@@ -171,8 +209,8 @@ export namespace vireo {
             const Buffer& source,
             const Buffer& destination,
             size_t size,
-            uint32_t sourceOffset,
-            uint32_t destinationOffset) const override;
+            size_t sourceOffset,
+            size_t destinationOffset) const override;
 
         void copy(
             const Buffer& source,
@@ -187,7 +225,7 @@ export namespace vireo {
         void copy(
             const Image& source,
             const Buffer& destination,
-            uint32_t destinationOffset,
+            size_t destinationOffset,
             uint32_t firstMipLevel) const override;
 
         void copy(
@@ -198,6 +236,8 @@ export namespace vireo {
 
         void endRendering() override;
 
+        void executeCommands(const std::vector<std::shared_ptr<const CommandList>>& commandLists) override;
+
         void dispatch(uint32_t x, uint32_t y, uint32_t z) const override;
 
         void bindVertexBuffers(
@@ -296,6 +336,14 @@ export namespace vireo {
            ResourceState oldState,
            ResourceState newState) const override;
 
+        void barrier(
+            const std::shared_ptr<const Image>& before,
+            const std::shared_ptr<const Image>& after) const override;
+
+        void barrier(
+            const Buffer& before,
+            const Buffer& after) const override;
+
         void pushConstants(
             const std::shared_ptr<const PipelineResources>& pipelineResources,
             const PushConstantsDesc& pushConstants,
@@ -307,6 +355,8 @@ export namespace vireo {
 
     private:
         ComPtr<ID3D12Device>                device;
+        // Bundles are executed by other command lists and keep their viewports & scissors
+        const bool                          bundle;
         ComPtr<ID3D12GraphicsCommandList>   commandList;
         ComPtr<ID3D12CommandAllocator>      commandAllocator;
         // Staging buffers used by the upload() methods
@@ -324,6 +374,16 @@ export namespace vireo {
         // Automatically allocated command signatures by stride size
         std::unordered_map<uint32_t, ComPtr<ID3D12CommandSignature>> drawIndirectCommandSignatures;
 
+        // Creates a mapped upload heap buffer used as a staging buffer by the upload() methods
+        ComPtr<ID3D12Resource> createStagingBuffer(size_t size, void** mappedAddress, const std::wstring& name);
+
+        // Records the copy of buffer rows, aligned on D3D12_TEXTURE_DATA_PITCH_ALIGNMENT, into a region of an image
+        void copyToRegion(
+            ID3D12Resource* buffer,
+            UINT64 offset,
+            const Image& destination,
+            const ImageRegion& region) const;
+
         inline static auto argDescIndexed = D3D12_INDIRECT_ARGUMENT_DESC{
             .Type = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED,
         };
@@ -338,6 +398,11 @@ export namespace vireo {
             uint32_t stride,
             uint32_t commandStride);
 
+        // Size of a vertex or index buffer view, the views are limited to 4GB
+        static UINT getViewSize(const UINT64 size) {
+            return static_cast<UINT>(std::min(size, UINT64{std::numeric_limits<UINT>::max()}));
+        }
+
         static void convertState(
             ResourceState oldState,
             ResourceState newState,
@@ -136,7 +136,9 @@ namespace vireo {
 
         void DXDescriptorSet::update(const DescriptorIndex index, const Buffer& buffer, const Buffer& counterBuffer) {
         assert(!layout->isSamplers());
-        assert(buffer.getType() == BufferType::READWRITE_STORAGE || buffer.getType() == BufferType::INDIRECT);
+        assert(buffer.getType() == BufferType::READWRITE_STORAGE ||
+               buffer.getType() == BufferType::INDIRECT ||
+               buffer.hasUsage(BufferUsage::READWRITE_STORAGE));
         const auto cpuHandle = D3D12_CPU_DESCRIPTOR_HANDLE { descriptors.cpuHandle.ptr + index * heap->getDescriptorSize() };
         const auto& dxBuffer = static_cast<const DXBuffer&>(buffer);
         const auto& dxCounterBuffer = static_cast<const DXBuffer&>(counterBuffer);
@@ -168,7 +170,8 @@ namespace vireo {
             };
             device->CreateConstantBufferView(&bufferViewDesc, cpuHandle);
         } else if (buffer.getType() == BufferType::READWRITE_STORAGE ||
-                   buffer.getType() == BufferType::INDIRECT) {
+                   buffer.getType() == BufferType::INDIRECT ||
+                   buffer.hasUsage(BufferUsage::READWRITE_STORAGE)) {
             const auto uavDesc = D3D12_UNORDERED_ACCESS_VIEW_DESC{
                 .ViewDimension = D3D12_UAV_DIMENSION_BUFFER,
                 .Buffer = {
@@ -184,7 +187,8 @@ namespace vireo {
             );
         } else if (
             buffer.getType() == BufferType::STORAGE ||
-            buffer.getType() == BufferType::DEVICE_STORAGE) {
+            buffer.getType() == BufferType::DEVICE_STORAGE ||
+            buffer.hasUsage(BufferUsage::STORAGE)) {
             const auto srvDesc = D3D12_SHADER_RESOURCE_VIEW_DESC {
                 .Format = DXGI_FORMAT_UNKNOWN,
                 .ViewDimension = D3D12_SRV_DIMENSION_BUFFER,
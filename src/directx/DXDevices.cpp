@@ -74,6 +74,13 @@ namespace vireo {
             infoQueue->SetBreakOnSeverity(D3D12_MESSAGE_SEVERITY_WARNING, FALSE);
         }
 #endif
-    }
+        auto architecture = D3D12_FEATURE_DATA_ARCHITECTURE{};
+        dxCheck(device->CheckFeatureSupport(D3D12_FEATURE_ARCHITECTURE, &architecture, sizeof(architecture)));
+        uma = architecture.UMA;
+        // Older runtimes don't know OPTIONS16
+        auto options16 = D3D12_FEATURE_DATA_D3D12_OPTIONS16{};
+        gpuUploadHeapSupported =
+            SUCCEEDED(device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS16, &options16, sizeof(options16))) &&
+            options16.GPUUploadHeapSupported;
 
 }
@@ -50,8 +50,17 @@ export namespace vireo {
 
         auto getDevice() { return device; }
 
+        // Returns true if the device shares the system memory (integrated and software devices)
+        auto isUMA() const { return uma; }
+
+        // Returns true if the device supports the GPU upload heap (resizable BAR)
+        auto isGPUUploadHeapSupported() const { return gpuUploadHeapSupported; }
+
     private:
         ComPtr<ID3D12Device> device;
+        // Features queried once at creation
+        bool                 uma{false};
+        bool                 gpuUploadHeapSupported{false};
     };
 
 }
\ No newline at end of file
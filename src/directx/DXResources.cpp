@@ -14,14 +14,42 @@ import vireo.directx.tools;
 
 namespace vireo {
 
+    DXMemoryHeap::DXMemoryHeap(
+        const ComPtr<ID3D12Device>& device,
+        const size_t size,
+        const MemoryHeapUsage usage,
+        const std::wstring& name) :
+        MemoryHeap{size, usage} {
+        const auto heapDesc = D3D12_HEAP_DESC {
+            .SizeInBytes = (size + PLACEMENT_ALIGNMENT - 1) & ~(PLACEMENT_ALIGNMENT - 1),
+            .Properties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+            .Alignment = D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT,
+            // Buffers, images & render targets in the same heap needs resource heap tier 2
+            .Flags = dxHeapFlags[static_cast<int>(usage)],
+        };
+        dxCheck(device->CreateHeap(&heapDesc, IID_PPV_ARGS(&heap)));
+#ifdef _DEBUG
+        heap->SetName((L"DXMemoryHeap : " + name).c_str());
+#endif
+    }
+
     DXBuffer::DXBuffer(
         const ComPtr<ID3D12Device>& device,
         const BufferType type,
         const size_t size,
         const size_t count,
-        const std::wstring& name):
-        Buffer{type},
-        size{size} {
+        const std::wstring& name,
+        const bool persistent,
+        const uint32_t versionCount,
+        const BufferUsage additionalUsage,
+        const std::shared_ptr<const DXMemoryHeap>& heap,
+        const size_t heapOffset,
+        const D3D12_HEAP_TYPE hostWriteHeapType,
+        const bool uma):
+        Buffer{type, additionalUsage},
+        size{size},
+        heap{heap} {
+        assert(versionCount > 0);
         auto minOffsetAlignment = 0;
         if (type == BufferType::UNIFORM) {
             minOffsetAlignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT;
@@ -34,8 +62,17 @@ namespace vireo {
         bufferSize = instanceSizeAligned * count;
         instanceSize = size;
         instanceCount = count;
+        persistentlyMapped = persistent;
+        this->versionCount = versionCount;
+        // Each copy of the content must be usable as a constant buffer address
+        const size_t versionAlignment = versionCount > 1 ? D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT : 1;
+        versionSize = (bufferSize + versionAlignment - 1) & ~(versionAlignment - 1);
 
-        const auto heapProperties = CD3DX12_HEAP_PROPERTIES(
+        assert(!hasUsage(BufferUsage::HOST_WRITE) ||
+            (type != BufferType::IMAGE_DOWNLOAD && type != BufferType::BUFFER_DOWNLOAD));
+        const auto heapType =
+            hasUsage(BufferUsage::HOST_WRITE) ?
+            hostWriteHeapType :
             type == BufferType::UNIFORM ||
             type == BufferType::STORAGE ||
             type == BufferType::IMAGE_UPLOAD ||
@@ -44,52 +81,65 @@ namespace vireo {
             type == BufferType::IMAGE_DOWNLOAD ||
             type == BufferType::BUFFER_DOWNLOAD ?
             D3D12_HEAP_TYPE_READBACK :
-            D3D12_HEAP_TYPE_DEFAULT
-        );
+            D3D12_HEAP_TYPE_DEFAULT;
+        const auto heapProperties = CD3DX12_HEAP_PROPERTIES(heapType);
+        // On UMA devices all the heaps are in the device local memory
+        deviceLocal = uma ||
+            heapType == D3D12_HEAP_TYPE_DEFAULT ||
+            heapType == D3D12_HEAP_TYPE_GPU_UPLOAD;
         int flag =
-            type == BufferType::READWRITE_STORAGE || type == BufferType::INDIRECT ?
+            type == BufferType::READWRITE_STORAGE ||
+            type == BufferType::INDIRECT ||
+            hasUsage(BufferUsage::READWRITE_STORAGE) ?
             D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS :
             D3D12_RESOURCE_FLAG_NONE;
-        const auto resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(bufferSize, static_cast<D3D12_RESOURCE_FLAGS >(flag));
-        dxCheck(device->CreateCommittedResource(
-            &heapProperties,
-            D3D12_HEAP_FLAG_NONE,
-            &resourceDesc,
-            D3D12_RESOURCE_STATE_COMMON,
-            nullptr,
-            IID_PPV_ARGS(&buffer)));
-        if constexpr (isMemoryUsageEnabled()) {
-            auto lock = std::lock_guard(memoryAllocationsMutex);
-            memoryAllocations.push_back({
-                VideoMemoryAllocationUsage::BUFFER,
-                name,
-                bufferSize,
-                buffer.Get() });
+        const auto resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(
+            versionSize * versionCount,
+            static_cast<D3D12_RESOURCE_FLAGS >(flag));
+        if (heap) {
+            dxCheck(device->CreatePlacedResource(
+                heap->getHeap().Get(),
+                heapOffset,
+                &resourceDesc,
+                D3D12_RESOURCE_STATE_COMMON,
+                nullptr,
+                IID_PPV_ARGS(&buffer)));
+        } else {
+            dxCheck(device->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &resourceDesc,
+                D3D12_RESOURCE_STATE_COMMON,
+                nullptr,
+                IID_PPV_ARGS(&buffer)));
         }
+        trackMemoryUsage(versionSize * versionCount);
 #ifdef _DEBUG
         buffer->SetName((L"DXBuffer : " + name).c_str());
 #endif
+        if (persistentlyMapped) {
+            const CD3DX12_RANGE readRange(0, 0);
+            dxCheck(buffer->Map(0, &readRange, &mappedAddress));
+        }
     }
 
      DXBuffer::~DXBuffer() {
         if (mappedAddress) {
-            DXBuffer::unmap();
+            buffer->Unmap(0, nullptr);
+            mappedAddress = nullptr;
         }
-        // if constexpr(isMemoryUsageEnabled()) {
-            // auto lock = std::lock_guard(memoryAllocationsMutex);
-            // memoryAllocations.remove_if([&](const VideoMemoryAllocationDesc& usage) {
-                // return usage.ref == buffer.Get();
-            // });
-        // }
     }
 
     void DXBuffer::map() {
+        if (persistentlyMapped) { return; }
         assert(mappedAddress == nullptr);
         const CD3DX12_RANGE readRange(0, 0); // We do not intend to read from this resource on the CPU.
         dxCheck(buffer->Map(0, &readRange, &mappedAddress));
+        mappedAddress = static_cast<std::byte*>(mappedAddress) + getCurrentOffset();
     }
 
     void DXBuffer::unmap() {
+        if (persistentlyMapped) { return; }
         assert(mappedAddress != nullptr);
         buffer->Unmap(0, nullptr);
         mappedAddress = nullptr;
@@ -107,8 +157,12 @@ namespace vireo {
             const bool        isRenderTarget,
             const bool        isDepthBuffer,
             const ClearValue  clearValue,
-            const MSAA        msaa):
-        Image{format, width, height, mipLevels, arraySize, useByComputeShader} {
+            const MSAA        msaa,
+            const ImageUsage  imageUsage,
+            const std::shared_ptr<const DXMemoryHeap>& heap,
+            const size_t      heapOffset):
+        Image{format, width, height, mipLevels, arraySize, useByComputeShader, imageUsage},
+        heap{heap} {
         const auto dxFormat = dxFormats[static_cast<int>(format)];
         const auto samples = DXPhysicalDevice::dxSampleCount[static_cast<int>(msaa)];
         UINT quality = 0;
@@ -122,7 +176,7 @@ namespace vireo {
             quality = qualityLevels.NumQualityLevels > 0 ? qualityLevels.NumQualityLevels - 1 : 0;
         }
         const auto heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
-        const auto imageDesc = D3D12_RESOURCE_DESC{
+        auto imageDesc = D3D12_RESOURCE_DESC{
             .Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D,
             .Width = width,
             .Height = height,
@@ -140,6 +194,15 @@ namespace vireo {
                 useByComputeShader ? D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS :
                 D3D12_RESOURCE_FLAG_NONE,
         };
+        // DirectX 12 have no lazily allocated memory, transient render targets are only attachments
+        assert(!hasUsage(ImageUsage::TRANSIENT) || (isRenderTarget && imageUsage == ImageUsage::TRANSIENT));
+        if (isRenderTarget && isDepthBuffer && imageUsage != ImageUsage::DEFAULT && !hasUsage(ImageUsage::SAMPLED)) {
+            // Depth buffers never read by shaders can skip the decompression needed for the SRV
+            imageDesc.Flags |= D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE;
+        }
+        if (isRenderTarget && !isDepthBuffer && hasUsage(ImageUsage::STORAGE)) {
+            imageDesc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+        }
         auto dxClearValue = D3D12_CLEAR_VALUE{};
         if (isRenderTarget) {
             dxClearValue.Format = imageDesc.Format;
@@ -155,23 +218,28 @@ namespace vireo {
                 dxClearValue.Color[3] = clearValue.color[3];
             }
         }
-        dxCheck(device->CreateCommittedResource(
-            &heapProperties,
-            D3D12_HEAP_FLAG_NONE,
-            &imageDesc,
-            D3D12_RESOURCE_STATE_COMMON,
-            isRenderTarget ? &dxClearValue : nullptr,
-            IID_PPV_ARGS(&image)));
+        if (heap) {
+            dxCheck(device->CreatePlacedResource(
+                heap->getHeap().Get(),
+                heapOffset,
+                &imageDesc,
+                D3D12_RESOURCE_STATE_COMMON,
+                isRenderTarget ? &dxClearValue : nullptr,
+                IID_PPV_ARGS(&image)));
+        } else {
+            dxCheck(device->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &imageDesc,
+                D3D12_RESOURCE_STATE_COMMON,
+                isRenderTarget ? &dxClearValue : nullptr,
+                IID_PPV_ARGS(&image)));
+        }
 
         if constexpr (isMemoryUsageEnabled()) {
             const auto allocInfo = device->GetResourceAllocationInfo(
                 0,1, &imageDesc);
-            auto lock = std::lock_guard(memoryAllocationsMutex);
-            memoryAllocations.push_back({
-                VideoMemoryAllocationUsage::IMAGE,
-                name,
-                allocInfo.SizeInBytes,
-                image.Get() });
+            trackMemoryUsage(allocInfo.SizeInBytes);
         }
 #ifdef _DEBUG
         image->SetName((L"DXIMage : " + name).c_str());
@@ -179,12 +247,6 @@ namespace vireo {
     }
 
     DXImage::~DXImage() {
-        // if constexpr(isMemoryUsageEnabled()) {
-            // auto lock = std::lock_guard(memoryAllocationsMutex);
-            // memoryAllocations.remove_if([&](const VideoMemoryAllocationDesc& usage) {
-                // return usage.ref == image.Get();
-            // });
-        // }
     }
 
     DXSampler::DXSampler(
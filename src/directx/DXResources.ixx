@@ -12,6 +12,27 @@ import vireo;
 
 export namespace vireo {
 
+    class DXMemoryHeap : public MemoryHeap {
+    public:
+        static constexpr D3D12_HEAP_FLAGS dxHeapFlags[] {
+            D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES,
+            D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS,
+            D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES,
+            D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES,
+        };
+
+        DXMemoryHeap(
+            const ComPtr<ID3D12Device>& device,
+            size_t size,
+            MemoryHeapUsage usage,
+            const std::wstring& name);
+
+        auto& getHeap() const { return heap; }
+
+    private:
+        ComPtr<ID3D12Heap> heap;
+    };
+
     class DXBuffer : public Buffer {
     public:
         static constexpr D3D12_RESOURCE_STATES resourceStates[] {
@@ -32,7 +53,14 @@ export namespace vireo {
             BufferType type,
             size_t size,
             size_t count,
-            const std::wstring& name);
+            const std::wstring& name,
+            bool persistent = false,
+            uint32_t versionCount = 1,
+            BufferUsage additionalUsage = BufferUsage::NONE,
+            const std::shared_ptr<const DXMemoryHeap>& heap = nullptr,
+            size_t heapOffset = 0,
+            D3D12_HEAP_TYPE hostWriteHeapType = D3D12_HEAP_TYPE_UPLOAD,
+            bool uma = false);
 
         ~DXBuffer() override;
 
@@ -48,6 +76,8 @@ export namespace vireo {
         const size_t           size;
         ComPtr<ID3D12Device>   device;
         ComPtr<ID3D12Resource> buffer;
+        // Heap of a placed buffer
+        const std::shared_ptr<const DXMemoryHeap> heap;
     };
 
     class DXSampler : public Sampler {
@@ -171,7 +201,10 @@ export namespace vireo {
             bool        isRenderTarget,
             bool        isDepthBuffer,
             ClearValue  clearValue,
-            MSAA        msaa);
+            MSAA        msaa,
+            ImageUsage  imageUsage = ImageUsage::DEFAULT,
+            const std::shared_ptr<const DXMemoryHeap>& heap = nullptr,
+            size_t      heapOffset = 0);
 
         auto getImage() const { return image; }
 
@@ -180,6 +213,8 @@ export namespace vireo {
     private:
         ComPtr<ID3D12Device>   device;
         ComPtr<ID3D12Resource> image;
+        // Heap of a placed image
+        const std::shared_ptr<const DXMemoryHeap> heap;
     };
 
     class DXRenderTarget : public RenderTarget {
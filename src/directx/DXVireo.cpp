@@ -8,10 +8,12 @@ module;
 #include "vireo/backend/directx/Libraries.h"
 module vireo.directx;
 
+import vireo.tools;
 import vireo.directx.commands;
 import vireo.directx.pipelines;
 import vireo.directx.resources;
 import vireo.directx.swapchains;
+import vireo.directx.tools;
 
 namespace vireo {
 
@@ -104,7 +106,82 @@ namespace vireo {
         const size_t size,
         const size_t count,
         const std::wstring& name) const {
-        return std::make_shared<DXBuffer>(getDXDevice()->getDevice(), type, size, count, name);
+        return std::make_shared<DXBuffer>(
+            getDXDevice()->getDevice(), type, size, count, name,
+            false, 1, BufferUsage::NONE,
+            nullptr, 0,
+            D3D12_HEAP_TYPE_UPLOAD, getDXDevice()->isUMA());
+    }
+
+    std::shared_ptr<Buffer> DXVireo::createBuffer(
+        const BufferType type,
+        const BufferUsage usage,
+        const size_t size,
+        const size_t count,
+        const std::wstring& name) const {
+        return std::make_shared<DXBuffer>(
+            getDXDevice()->getDevice(), type, size, count, name,
+            false, 1, usage,
+            nullptr, 0,
+            (usage & BufferUsage::HOST_WRITE) != BufferUsage::NONE ?
+                getHostWriteHeapType(getDXDevice()->isGPUUploadHeapSupported(), getMemoryBudget(), size * count) :
+                D3D12_HEAP_TYPE_UPLOAD,
+            getDXDevice()->isUMA());
+    }
+
+    D3D12_HEAP_TYPE DXVireo::getHostWriteHeapType(
+        const bool gpuUploadHeapSupported,
+        const VideoMemoryBudget& budget,
+        const size_t size) {
+        if (!gpuUploadHeapSupported) {
+            return D3D12_HEAP_TYPE_UPLOAD;
+        }
+        const auto& localMemory = budget.heaps[0];
+        return localMemory.usage + size <= localMemory.budget ? D3D12_HEAP_TYPE_GPU_UPLOAD : D3D12_HEAP_TYPE_UPLOAD;
+    }
+
+    std::shared_ptr<Buffer> DXVireo::createMappedBuffer(
+        const BufferType type,
+        const size_t size,
+        const size_t count,
+        const uint32_t versionCount,
+        const std::wstring& name) const {
+        assert(type == BufferType::UNIFORM || type == BufferType::STORAGE);
+        if (versionCount > 1 && type != BufferType::UNIFORM) {
+            // Only the UNIFORM_DYNAMIC descriptors can select the current version with a dynamic offset
+            throw Exception("Only UNIFORM mapped buffers can have more than one version");
+        }
+        return std::make_shared<DXBuffer>(
+            getDXDevice()->getDevice(), type, size, count, name,
+            true, versionCount, BufferUsage::NONE,
+            nullptr, 0,
+            D3D12_HEAP_TYPE_UPLOAD, getDXDevice()->isUMA());
+    }
+
+    VideoMemoryBudget DXVireo::getMemoryBudget() const {
+        const auto adapter = getDXPhysicalDevice()->getHardwareAdapter();
+        auto desc = DXGI_ADAPTER_DESC3{};
+        dxCheck(adapter->GetDesc3(&desc));
+        // DXGI reports the dedicated video memory and the shared system memory
+        const DXGI_MEMORY_SEGMENT_GROUP segmentGroups[] = {
+            DXGI_MEMORY_SEGMENT_GROUP_LOCAL,
+            DXGI_MEMORY_SEGMENT_GROUP_NON_LOCAL,
+        };
+        const size_t segmentSizes[] = { desc.DedicatedVideoMemory, desc.SharedSystemMemory };
+        auto budget = VideoMemoryBudget{ .heapCount = 2 };
+        for (uint32_t i = 0; i < budget.heapCount; i++) {
+            auto info = DXGI_QUERY_VIDEO_MEMORY_INFO{};
+            dxCheck(adapter->QueryVideoMemoryInfo(0, segmentGroups[i], &info));
+            budget.heaps[i] = {
+                .size = segmentSizes[i],
+                .deviceLocal = segmentGroups[i] == DXGI_MEMORY_SEGMENT_GROUP_LOCAL,
+                // Resources are committed by the driver, the process usage is the closest value
+                .allocated = info.CurrentUsage,
+                .usage = info.CurrentUsage,
+                .budget = info.Budget,
+            };
+        }
+        return budget;
     }
 
     std::shared_ptr<Image> DXVireo::createImage(
@@ -113,7 +190,8 @@ namespace vireo {
         const uint32_t height,
         const uint32_t mipLevels,
         const uint32_t arraySize,
-        const std::wstring& name) const {
+        const std::wstring& name,
+        const ImageUsage usage) const {
         return std::make_shared<DXImage>(
             getDXDevice()->getDevice(),
             format,
@@ -121,9 +199,10 @@ namespace vireo {
             mipLevels,
             arraySize,
             name,
-            false, false, false,
+            (usage & ImageUsage::STORAGE) == ImageUsage::STORAGE, false, false,
             DXImage::defaultClearValue,
-            MSAA::NONE);
+            MSAA::NONE,
+            usage);
     }
 
     std::shared_ptr<Image> DXVireo::createReadWriteImage(
@@ -152,7 +231,8 @@ namespace vireo {
            const RenderTargetType type,
            const ClearValue clearValue,
            const MSAA msaa,
-           const std::wstring& name) const {
+           const std::wstring& name,
+           const ImageUsage usage) const {
         return std::make_shared<DXRenderTarget>(
             getDXDevice()->getDevice(),
             std::make_shared<DXImage>(
@@ -167,7 +247,8 @@ namespace vireo {
                 true,
                 type == RenderTargetType::DEPTH || type == RenderTargetType::DEPTH_STENCIL,
                 clearValue,
-                msaa),
+                msaa,
+                usage),
             type);
     }
 
@@ -175,7 +256,8 @@ namespace vireo {
            const std::shared_ptr<const SwapChain>& swapChain,
            const ClearValue clearValue,
            const MSAA msaa,
-           const std::wstring& name) const {
+           const std::wstring& name,
+           const ImageUsage usage) const {
         return std::make_shared<DXRenderTarget>(
             getDXDevice()->getDevice(),
             std::make_shared<DXImage>(
@@ -190,9 +272,106 @@ namespace vireo {
                 true,
                 false,
                 clearValue,
-                msaa),
+                msaa,
+                usage),
             RenderTargetType::COLOR);
     }
+
+    std::shared_ptr<MemoryHeap> DXVireo::createMemoryHeap(
+        const size_t size,
+        const std::wstring& name,
+        const MemoryHeapUsage usage) const {
+        return std::make_shared<DXMemoryHeap>(getDXDevice()->getDevice(), size, usage, name);
+    }
+
+    std::shared_ptr<Buffer> DXVireo::createPlacedBuffer(
+        const std::shared_ptr<const MemoryHeap>& heap,
+        const size_t offset,
+        const BufferType type,
+        const size_t size,
+        const size_t count,
+        const std::wstring& name) const {
+        assert(heap != nullptr);
+        if (!heap->isUsageAllowed(MemoryHeapUsage::BUFFERS)) {
+            throw Exception("Resource class not allowed in the memory heap");
+        }
+        assert(type == BufferType::VERTEX ||
+               type == BufferType::INDEX ||
+               type == BufferType::INDIRECT ||
+               type == BufferType::DEVICE_STORAGE ||
+               type == BufferType::READWRITE_STORAGE);
+        return std::make_shared<DXBuffer>(
+            getDXDevice()->getDevice(), type, size, count, name,
+            false, 1, BufferUsage::NONE,
+            static_pointer_cast<const DXMemoryHeap>(heap), offset,
+            D3D12_HEAP_TYPE_UPLOAD, getDXDevice()->isUMA());
+    }
+
+    std::shared_ptr<Image> DXVireo::createPlacedImage(
+        const std::shared_ptr<const MemoryHeap>& heap,
+        const size_t offset,
+        const ImageFormat format,
+        const uint32_t width,
+        const uint32_t height,
+        const uint32_t mipLevels,
+        const uint32_t arraySize,
+        const std::wstring& name,
+        const ImageUsage usage) const {
+        assert(heap != nullptr);
+        if (!heap->isUsageAllowed(MemoryHeapUsage::IMAGES)) {
+            throw Exception("Resource class not allowed in the memory heap");
+        }
+        return std::make_shared<DXImage>(
+            getDXDevice()->getDevice(),
+            format,
+            width, height,
+            mipLevels,
+            arraySize,
+            name,
+            (usage & ImageUsage::STORAGE) == ImageUsage::STORAGE, false, false,
+            DXImage::defaultClearValue,
+            MSAA::NONE,
+            usage,
+            static_pointer_cast<const DXMemoryHeap>(heap),
+            offset);
+    }
+
+    std::shared_ptr<RenderTarget> DXVireo::createPlacedRenderTarget(
+           const std::shared_ptr<const MemoryHeap>& heap,
+           const size_t offset,
+           const ImageFormat format,
+           const uint32_t width,
+           const uint32_t height,
+           const RenderTargetType type,
+           const ClearValue clearValue,
+           const MSAA msaa,
+           const std::wstring& name,
+           const ImageUsage usage) const {
+        assert(heap != nullptr);
+        if (!heap->isUsageAllowed(MemoryHeapUsage::RENDER_TARGETS)) {
+            throw Exception("Resource class not allowed in the memory heap");
+        }
+        return std::make_shared<DXRenderTarget>(
+            getDXDevice()->getDevice(),
+            std::make_shared<DXImage>(
+                getDXDevice()->getDevice(),
+                format,
+                width,
+                height,
+                1,
+                1,
+                name,
+                false,
+                true,
+                type == RenderTargetType::DEPTH || type == RenderTargetType::DEPTH_STENCIL,
+                clearValue,
+                msaa,
+                usage,
+                static_pointer_cast<const DXMemoryHeap>(heap),
+                offset),
+            type);
+    }
+
     std::shared_ptr<DescriptorLayout> DXVireo::createDescriptorLayout(
         const std::wstring& name) const {
         return std::make_shared<DXDescriptorLayout>(false, false);
@@ -18,6 +18,8 @@ export namespace vireo {
     public:
         DXVireo(uint32_t maxDescriptors, uint32_t maxSamplers);
 
+        VideoMemoryBudget getMemoryBudget() const override;
+
         std::shared_ptr<SwapChain> createSwapChain(
             ImageFormat format,
             const std::shared_ptr<const SubmitQueue>& submitQueue,
@@ -72,13 +74,28 @@ export namespace vireo {
             size_t count,
             const std::wstring& name) const override;
 
+        std::shared_ptr<Buffer> createBuffer(
+            BufferType type,
+            BufferUsage usage,
+            size_t size,
+            size_t count,
+            const std::wstring& name) const override;
+
+        std::shared_ptr<Buffer> createMappedBuffer(
+            BufferType type,
+            size_t size,
+            size_t count,
+            uint32_t versionCount,
+            const std::wstring& name) const override;
+
         std::shared_ptr<Image> createImage(
             ImageFormat format,
             uint32_t width,
             uint32_t height,
             uint32_t mipLevels,
             uint32_t arraySize,
-            const std::wstring& name) const override;
+            const std::wstring& name,
+            ImageUsage usage) const override;
 
         std::shared_ptr<Image> createReadWriteImage(
             ImageFormat format,
@@ -95,14 +112,52 @@ export namespace vireo {
             RenderTargetType type,
             ClearValue clearValue,
             MSAA msaa,
-            const std::wstring& name) const override;
+            const std::wstring& name,
+            ImageUsage usage) const override;
 
         std::shared_ptr<RenderTarget> createRenderTarget(
             const std::shared_ptr<const SwapChain>& swapChain,
             ClearValue clearValue,
             MSAA msaa,
+            const std::wstring& name,
+            ImageUsage usage) const override;
+
+        std::shared_ptr<MemoryHeap> createMemoryHeap(
+            size_t size,
+            const std::wstring& name,
+            MemoryHeapUsage usage) const override;
+
+        std::shared_ptr<Buffer> createPlacedBuffer(
+            const std::shared_ptr<const MemoryHeap>& heap,
+            size_t offset,
+            BufferType type,
+            size_t size,
+            size_t count,
             const std::wstring& name) const override;
 
+        std::shared_ptr<Image> createPlacedImage(
+            const std::shared_ptr<const MemoryHeap>& heap,
+            size_t offset,
+            ImageFormat format,
+            uint32_t width,
+            uint32_t height,
+            uint32_t mipLevels,
+            uint32_t arraySize,
+            const std::wstring& name,
+            ImageUsage usage) const override;
+
+        std::shared_ptr<RenderTarget> createPlacedRenderTarget(
+            const std::shared_ptr<const MemoryHeap>& heap,
+            size_t offset,
+            ImageFormat format,
+            uint32_t width,
+            uint32_t height,
+            RenderTargetType type,
+            ClearValue clearValue,
+            MSAA msaa,
+            const std::wstring& name,
+            ImageUsage usage) const override;
+
         std::shared_ptr<DescriptorLayout> createDescriptorLayout(
             const std::wstring& name) const override;
 
@@ -146,6 +201,13 @@ export namespace vireo {
         std::shared_ptr<DXDescriptorHeap> cbvSrvUavDescriptorHeap;
         // D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER global heap
         std::shared_ptr<DXDescriptorHeap> samplerDescriptorHeap;
+
+        // Returns the heap type of the HOST_WRITE buffers : the GPU upload heap (resizable BAR) if the device
+        // supports it and the local memory stays within the budget, the upload heap otherwise
+        static D3D12_HEAP_TYPE getHostWriteHeapType(
+            bool gpuUploadHeapSupported,
+            const VideoMemoryBudget& budget,
+            size_t size);
    };
 
 }
\ No newline at end of file
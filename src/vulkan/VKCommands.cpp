@@ -21,7 +21,8 @@ namespace vireo {
     VKSubmitQueue::VKSubmitQueue(
         const std::shared_ptr<const VKDevice>& device,
         const CommandType type,
-        const std::wstring& name) {
+        const std::wstring& name) :
+        device{device} {
         vkGetDeviceQueue(
             device->getDevice(),
             type == CommandType::COMPUTE ? device->getComputeQueueFamilyIndex() :
@@ -32,13 +33,58 @@ namespace vireo {
 #ifdef _DEBUG
         vkSetObjectName(device->getDevice(), reinterpret_cast<uint64_t>(commandQueue), VK_OBJECT_TYPE_QUEUE,
             "VKSubmitQueue : " + to_string(name));
+#endif
+        const auto timelineInfo = VkSemaphoreTypeCreateInfo {
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+            .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+            .initialValue = 0,
+        };
+        const auto semaphoreInfo = VkSemaphoreCreateInfo {
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+            .pNext = &timelineInfo,
+        };
+        vkCheck(vkCreateSemaphore(device->getDevice(), &semaphoreInfo, nullptr, &retireSemaphore));
+#ifdef _DEBUG
+        vkSetObjectName(device->getDevice(), reinterpret_cast<uint64_t>(retireSemaphore), VK_OBJECT_TYPE_SEMAPHORE,
+            "VKSubmitQueue retire semaphore : " + to_string(name));
 #endif
     }
 
+    VKSubmitQueue::~VKSubmitQueue() {
+        // The staging ranges can't be retired by a destroyed semaphore
+        vkQueueWaitIdle(commandQueue);
+        device->getStagingRing().releaseRetired(retireSemaphore);
+        vkDestroySemaphore(device->getDevice(), retireSemaphore, nullptr);
+    }
+
     void VKSubmitQueue::waitIdle() const {
         vkQueueWaitIdle(commandQueue);
     }
 
+    void VKSubmitQueue::queueSubmit(
+        VkSubmitInfo2 submitInfo,
+        const VkFence fence,
+        const std::vector<std::shared_ptr<const CommandList>>& commandLists) const {
+        // Also signals the retire semaphore so the staging memory of the command lists is released
+        // as soon as this submission is finished
+        auto signalInfos = std::vector<VkSemaphoreSubmitInfo>(
+            submitInfo.pSignalSemaphoreInfos,
+            submitInfo.pSignalSemaphoreInfos + submitInfo.signalSemaphoreInfoCount);
+        submittedValue += 1;
+        signalInfos.push_back({
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+            .semaphore = retireSemaphore,
+            .value = submittedValue,
+            .stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+        });
+        submitInfo.signalSemaphoreInfoCount = static_cast<uint32_t>(signalInfos.size());
+        submitInfo.pSignalSemaphoreInfos = signalInfos.data();
+        vkCheck(vkQueueSubmit2(commandQueue, 1, &submitInfo, fence));
+        for (const auto& commandList : commandLists) {
+            static_pointer_cast<const VKCommandList>(commandList)->retireStaging(retireSemaphore, submittedValue);
+        }
+    }
+
     void VKSubmitQueue::submit(
         const std::shared_ptr<Fence>& fence,
         const std::shared_ptr<const SwapChain>& swapChain,
@@ -64,7 +110,7 @@ namespace vireo {
             .signalSemaphoreInfoCount = 1,
             .pSignalSemaphoreInfos    = &vkSwapChain->getCurrentRenderFinishedSemaphoreInfo()
         };
-        vkCheck(vkQueueSubmit2(commandQueue, 1, &submitInfo, vkFence->getFence()));
+        queueSubmit(submitInfo, vkFence->getFence(), commandLists);
     }
 
     void VKSubmitQueue::submit(const std::vector<std::shared_ptr<const CommandList>>& commandLists) const {
@@ -83,7 +129,7 @@ namespace vireo {
             .pCommandBufferInfos      = submitInfos.data(),
             .signalSemaphoreInfoCount = 0,
         };
-        vkCheck(vkQueueSubmit2(commandQueue, 1, &submitInfo, VK_NULL_HANDLE));
+        queueSubmit(submitInfo, VK_NULL_HANDLE, commandLists);
     }
 
     void VKSubmitQueue::submit(
@@ -106,7 +152,7 @@ namespace vireo {
             .pCommandBufferInfos      = submitInfos.data(),
             .signalSemaphoreInfoCount = 0,
         };
-        vkCheck(vkQueueSubmit2(commandQueue, 1, &submitInfo, vkFence->getFence()));
+        queueSubmit(submitInfo, vkFence->getFence(), commandLists);
     }
 
     void VKSubmitQueue::submit(
@@ -154,7 +200,7 @@ namespace vireo {
             .signalSemaphoreInfoCount = signalSemaphore ? 1u : 0u,
             .pSignalSemaphoreInfos    = signalSemaphore ? &signalSemaphoreSubmitInfo : VK_NULL_HANDLE,
         };
-        vkCheck(vkQueueSubmit2(commandQueue, 1, &submitInfo, VK_NULL_HANDLE));
+        queueSubmit(submitInfo, VK_NULL_HANDLE, commandLists);
     }
 
     void VKSubmitQueue::submit(
@@ -205,7 +251,7 @@ namespace vireo {
             .signalSemaphoreInfoCount = signalSemaphore ? 1u : 0u,
             .pSignalSemaphoreInfos    = signalSemaphore ? &signalSemaphoreSubmitInfo : VK_NULL_HANDLE,
         };
-        vkCheck(vkQueueSubmit2(commandQueue, 1, &submitInfo, VK_NULL_HANDLE));
+        queueSubmit(submitInfo, VK_NULL_HANDLE, commandLists);
     }
 
 
@@ -251,7 +297,7 @@ namespace vireo {
             .signalSemaphoreInfoCount = 1,
             .pSignalSemaphoreInfos    = &vkSwapChain->getCurrentRenderFinishedSemaphoreInfo(),
         };
-        vkCheck(vkQueueSubmit2(commandQueue, 1, &submitInfo, vkFence->getFence()));
+        queueSubmit(submitInfo, vkFence->getFence(), commandLists);
     }
 
     void VKSubmitQueue::submit(
@@ -301,7 +347,7 @@ namespace vireo {
             .signalSemaphoreInfoCount = 1,
             .pSignalSemaphoreInfos    = &vkSwapChain->getCurrentRenderFinishedSemaphoreInfo(),
         };
-        vkCheck(vkQueueSubmit2(commandQueue, 1, &submitInfo, vkFence->getFence()));
+        queueSubmit(submitInfo, vkFence->getFence(), commandLists);
     }
 
     VKCommandAllocator::VKCommandAllocator(const std::shared_ptr<const VKDevice>& device, const CommandType type):
@@ -331,15 +377,24 @@ namespace vireo {
     }
 
     std::shared_ptr<CommandList> VKCommandAllocator::createCommandList() const {
-        return std::make_shared<VKCommandList>(device, commandPool);
+        return std::make_shared<VKCommandList>(device, commandPool, false);
     }
 
-    VKCommandList::VKCommandList(const std::shared_ptr<const VKDevice>& device, const VkCommandPool commandPool) :
-        device{device} {
+    std::shared_ptr<CommandList> VKCommandAllocator::createSecondaryCommandList() const {
+        assert(getCommandListType() == CommandType::GRAPHIC);
+        return std::make_shared<VKCommandList>(device, commandPool, true);
+    }
+
+    VKCommandList::VKCommandList(
+        const std::shared_ptr<const VKDevice>& device,
+        const VkCommandPool commandPool,
+        const bool secondary) :
+        device{device},
+        secondary{secondary} {
         const auto allocInfo = VkCommandBufferAllocateInfo {
             .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
             .commandPool        = commandPool,
-            .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .level              = secondary ? VK_COMMAND_BUFFER_LEVEL_SECONDARY : VK_COMMAND_BUFFER_LEVEL_PRIMARY,
             .commandBufferCount = 1,
         };
         vkCheck(vkAllocateCommandBuffers(device->getDevice(), &allocInfo, &commandBuffer));
@@ -358,22 +413,34 @@ namespace vireo {
             vkBuffers[i] = static_pointer_cast<const VKBuffer>(buffers[i])->getBuffer();
             vkOffsets[i] = offsets.empty() ? 0 : offsets[i];
         }
-        vkCmdBindVertexBuffers(commandBuffer, 0, buffers.size(), vkBuffers.data(), vkOffsets.data());
+        if (updateVertexBuffers(vkBuffers.size(), vkBuffers.data(), vkOffsets.data())) {
+            vkCmdBindVertexBuffers(commandBuffer, 0, vkBuffers.size(), vkBuffers.data(), vkOffsets.data());
+        }
     }
 
     void VKCommandList::bindVertexBuffer(const Buffer& buffer, const size_t offset) const {
         const auto& vkBuffer = static_cast<const VKBuffer&>(buffer);
         const VkBuffer     buffers[] = {vkBuffer.getBuffer()};
         const VkDeviceSize offsets[] = {offset};
-        vkCmdBindVertexBuffers(commandBuffer, 0, 1, buffers, offsets);
+        if (updateVertexBuffers(1, buffers, offsets)) {
+            vkCmdBindVertexBuffers(commandBuffer, 0, 1, buffers, offsets);
+        }
     }
 
     void VKCommandList::bindIndexBuffer(const Buffer& buffer, IndexType indexType, const uint32_t firstIndex) const {
-        const auto& vkBuffer = static_cast<const VKBuffer&>(buffer);
-        vkCmdBindIndexBuffer(commandBuffer,
-            vkBuffer.getBuffer(),
-            firstIndex * indexTypeSize[static_cast<int>(indexType)],
-            vkIndexTypes[static_cast<int>(indexType)]);
+        const auto vkBuffer = static_cast<const VKBuffer&>(buffer).getBuffer();
+        const auto offset = VkDeviceSize{firstIndex} * indexTypeSize[static_cast<int>(indexType)];
+        const auto vkIndexType = vkIndexTypes[static_cast<int>(indexType)];
+        if (shadowState.indexBuffer == vkBuffer &&
+            shadowState.indexOffset == offset &&
+            shadowState.indexType == vkIndexType) {
+            skippedStateCount++;
+            return;
+        }
+        shadowState.indexBuffer = vkBuffer;
+        shadowState.indexOffset = offset;
+        shadowState.indexType = vkIndexType;
+        vkCmdBindIndexBuffer(commandBuffer, vkBuffer, offset, vkIndexType);
     }
 
     void VKCommandList::draw(
@@ -381,6 +448,7 @@ namespace vireo {
         const uint32_t instanceCount,
         const uint32_t firstVertex,
         const uint32_t firstInstance) const {
+        flushBarriers();
         vkCmdDraw(commandBuffer, vertexCountPerInstance, instanceCount, firstVertex, firstInstance);
     }
 
@@ -391,6 +459,7 @@ namespace vireo {
         const uint32_t stride,
         const uint32_t firstCommandOffset) {
         const auto& vkBuffer = static_cast<const VKBuffer&>(buffer);
+        flushBarriers();
         vkCmdDrawIndirect(commandBuffer, vkBuffer.getBuffer(), offset, drawCount, stride);
     }
 
@@ -400,6 +469,7 @@ namespace vireo {
         const uint32_t firstIndex,
         const uint32_t vertexOffset,
         const uint32_t firstInstance) const {
+        flushBarriers();
         vkCmdDrawIndexed(commandBuffer, indexCountPerInstance, instanceCount, firstIndex, vertexOffset, firstInstance);
     }
 
@@ -410,6 +480,7 @@ namespace vireo {
         const uint32_t stride,
         const uint32_t firstCommandOffset) {
         const auto& vkBuffer = static_cast<const VKBuffer&>(buffer);
+        flushBarriers();
         vkCmdDrawIndexedIndirect(
             commandBuffer,
             vkBuffer.getBuffer(),
@@ -428,6 +499,7 @@ namespace vireo {
         const uint32_t firstCommandOffset) {
         const auto& vkBuffer = static_cast<const VKBuffer&>(buffer);
         const auto& vkCountBuffer = static_cast<const VKBuffer&>(countBuffer);
+        flushBarriers();
         vkCmdDrawIndexedIndirectCount(
             commandBuffer,
             vkBuffer.getBuffer(),
@@ -438,18 +510,27 @@ namespace vireo {
     }
 
     void VKCommandList::bindPipeline(Pipeline& pipeline) {
-        if (pipeline.getType() == PipelineType::COMPUTE) {
-            vkCmdBindPipeline(
-                commandBuffer,
-                VK_PIPELINE_BIND_POINT_COMPUTE ,
-                static_cast<const VKComputePipeline&>(pipeline).getPipeline());
-        } else {
-            vkCmdBindPipeline(
-                commandBuffer,
-                VK_PIPELINE_BIND_POINT_GRAPHICS ,
-                static_cast<const VKGraphicPipeline&>(pipeline).getPipeline());
-        }
+        const auto bindPoint = pipeline.getType() == PipelineType::COMPUTE ?
+            VK_PIPELINE_BIND_POINT_COMPUTE :
+            VK_PIPELINE_BIND_POINT_GRAPHICS;
+        const auto vkPipeline = pipeline.getType() == PipelineType::COMPUTE ?
+            static_cast<const VKComputePipeline&>(pipeline).getPipeline() :
+            static_cast<const VKGraphicPipeline&>(pipeline).getPipeline();
+        const auto vkLayout = static_pointer_cast<const VKPipelineResources>(pipeline.getResources())->getPipelineLayout();
         currentlyBoundPipeline = &pipeline;
+
+        auto& state = shadowState.bindPoints[bindPoint];
+        if (state.layout != vkLayout) {
+            // We don't check the layouts compatibility, the sets will be bound again with the new layout
+            state.layout = vkLayout;
+            state.descriptorSets.clear();
+        }
+        if (state.pipeline == vkPipeline) {
+            skippedStateCount++;
+            return;
+        }
+        state.pipeline = vkPipeline;
+        vkCmdBindPipeline(commandBuffer, bindPoint, vkPipeline);
     }
 
     void VKCommandList::bindDescriptors(
@@ -462,10 +543,14 @@ namespace vireo {
         for (int i = 0; i < descriptors.size(); i++) {
             descriptorSets[i] = static_pointer_cast<const VKDescriptorSet>(descriptors[i])->getSet();
         }
+        const auto bindPoint = currentlyBoundPipeline->getType() == PipelineType::COMPUTE ?
+            VK_PIPELINE_BIND_POINT_COMPUTE :
+            VK_PIPELINE_BIND_POINT_GRAPHICS;
+        if (!updateDescriptorSets(bindPoint, firstSet, descriptorSets.size(), descriptorSets.data(), nullptr)) {
+            return;
+        }
         vkCmdBindDescriptorSets(commandBuffer,
-                                currentlyBoundPipeline->getType() == PipelineType::COMPUTE ?
-                                    VK_PIPELINE_BIND_POINT_COMPUTE :
-                                    VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                bindPoint,
                                 vkLayout,
                                 firstSet,
                                 descriptorSets.size(),
@@ -480,10 +565,14 @@ namespace vireo {
         assert(currentlyBoundPipeline != nullptr);
         const auto vkLayout = static_pointer_cast<const VKPipelineResources>(currentlyBoundPipeline->getResources())->getPipelineLayout();
         const auto& descriptorSet = static_cast<const VKDescriptorSet&>(descriptor).getSet();
+        const auto bindPoint = currentlyBoundPipeline->getType() == PipelineType::COMPUTE ?
+            VK_PIPELINE_BIND_POINT_COMPUTE :
+            VK_PIPELINE_BIND_POINT_GRAPHICS;
+        if (!updateDescriptorSets(bindPoint, set, 1, &descriptorSet, nullptr)) {
+            return;
+        }
         vkCmdBindDescriptorSets(commandBuffer,
-                                currentlyBoundPipeline->getType() == PipelineType::COMPUTE ?
-                                    VK_PIPELINE_BIND_POINT_COMPUTE :
-                                    VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                bindPoint,
                                 vkLayout,
                                 set,
                                 1,
@@ -500,10 +589,14 @@ namespace vireo {
         assert(currentlyBoundPipeline != nullptr);
         const auto vkLayout = static_pointer_cast<const VKPipelineResources>(currentlyBoundPipeline->getResources())->getPipelineLayout();
         const auto& descriptorSet = static_cast<const VKDescriptorSet&>(descriptor).getSet();
+        const auto bindPoint = currentlyBoundPipeline->getType() == PipelineType::COMPUTE ?
+            VK_PIPELINE_BIND_POINT_COMPUTE :
+            VK_PIPELINE_BIND_POINT_GRAPHICS;
+        if (!updateDescriptorSets(bindPoint, set, 1, &descriptorSet, &offset)) {
+            return;
+        }
         vkCmdBindDescriptorSets(commandBuffer,
-                                currentlyBoundPipeline->getType() == PipelineType::COMPUTE ?
-                                    VK_PIPELINE_BIND_POINT_COMPUTE :
-                                    VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                bindPoint,
                                 vkLayout,
                                 set,
                                 1,
@@ -513,6 +606,11 @@ namespace vireo {
     }
 
     void VKCommandList::setStencilReference(const uint32_t reference) const {
+        if (shadowState.stencilReference == reference) {
+            skippedStateCount++;
+            return;
+        }
+        shadowState.stencilReference = reference;
         vkCmdSetStencilReference(commandBuffer, VK_STENCIL_FACE_FRONT_AND_BACK, reference);
     }
 
@@ -526,7 +624,9 @@ namespace vireo {
             vkViewports[i].minDepth = viewports[i].minDepth;
             vkViewports[i].maxDepth = viewports[i].maxDepth;
         }
-        vkCmdSetViewportWithCount(commandBuffer, vkViewports.size(), vkViewports.data());
+        if (updateViewports(vkViewports.size(), vkViewports.data())) {
+            vkCmdSetViewportWithCount(commandBuffer, vkViewports.size(), vkViewports.data());
+        }
     }
 
     void VKCommandList::setScissors(const std::vector<Rect>& rects) const {
@@ -536,7 +636,9 @@ namespace vireo {
             scissors[i].extent.width = rects[i].width;
             scissors[i].extent.height = rects[i].height;
         }
-        vkCmdSetScissorWithCount(commandBuffer, scissors.size(), scissors.data());
+        if (updateScissors(scissors.size(), scissors.data())) {
+            vkCmdSetScissorWithCount(commandBuffer, scissors.size(), scissors.data());
+        }
     }
 
     void VKCommandList::setViewport(const Viewport& viewport) const {
@@ -548,7 +650,9 @@ namespace vireo {
             .minDepth = viewport.minDepth,
             .maxDepth = viewport.maxDepth,
         };
-        vkCmdSetViewportWithCount(commandBuffer, 1, &vkViewport);
+        if (updateViewports(1, &vkViewport)) {
+            vkCmdSetViewportWithCount(commandBuffer, 1, &vkViewport);
+        }
     }
 
     void VKCommandList::setScissors(const Rect& rect) const {
@@ -556,7 +660,9 @@ namespace vireo {
             .offset = { max(rect.x, 0), max(rect.y, 0)},
             .extent = { rect.width, rect.height },
         };
-        vkCmdSetScissorWithCount(commandBuffer, 1, &scissor);
+        if (updateScissors(1, &scissor)) {
+            vkCmdSetScissorWithCount(commandBuffer, 1, &scissor);
+        }
     }
 
     void VKCommandList::beginRendering(const RenderingConfiguration& conf) {
@@ -637,7 +743,7 @@ namespace vireo {
             if (conf.colorRenderTargets[i].multisampledRenderTarget) {
                 const auto msaaColor =
                     static_pointer_cast<VKImage>(conf.colorRenderTargets[i].multisampledRenderTarget->getImage());
-                barrier(msaaColor->getImage(), ResourceState::UNDEFINED, ResourceState::RENDER_TARGET_COLOR, 1, 1);
+                barrier(msaaColor->getImage(), ResourceState::UNDEFINED, ResourceState::RENDER_TARGET_COLOR, 0, 1);
                 colorAttachmentsInfo[i].imageView = msaaColor->getImageView(),
                 colorAttachmentsInfo[i].resolveMode = VK_RESOLVE_MODE_AVERAGE_BIT;
                 colorAttachmentsInfo[i].resolveImageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
@@ -649,6 +755,9 @@ namespace vireo {
         const auto renderingInfo = VkRenderingInfo {
             .sType               = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR,
             .pNext                = nullptr,
+            .flags                = conf.secondaryCommandLists ?
+                static_cast<VkRenderingFlags>(VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT) :
+                0,
             .renderArea           = {
                 {0, 0},
                 {width, height}
@@ -659,6 +768,7 @@ namespace vireo {
             .pDepthAttachment     = depthAttachmentInfo.imageView != VK_NULL_HANDLE ? &depthAttachmentInfo : nullptr,
             .pStencilAttachment   = stencilAttachmentInfo.imageView != VK_NULL_HANDLE ? &stencilAttachmentInfo : nullptr,
         };
+        flushBarriers();
         vkCmdBeginRendering(commandBuffer, &renderingInfo);
     }
 
@@ -666,7 +776,21 @@ namespace vireo {
         vkCmdEndRendering(commandBuffer);
     }
 
+    void VKCommandList::executeCommands(const std::vector<std::shared_ptr<const CommandList>>& commandLists) {
+        assert(!secondary);
+        assert(!commandLists.empty());
+        const auto r = std::views::transform(commandLists, [](const std::shared_ptr<const CommandList>& commandList) {
+            return static_pointer_cast<const VKCommandList>(commandList)->getCommandBuffer();
+        });
+        const auto commandBuffers = std::vector<VkCommandBuffer>{r.begin(), r.end()};
+        vkCmdExecuteCommands(commandBuffer, commandBuffers.size(), commandBuffers.data());
+        // The state of the primary command buffer is undefined after the execution of secondary command buffers
+        shadowState = {};
+        currentlyBoundPipeline = nullptr;
+    }
+
     void VKCommandList::dispatch(const uint32_t x, const uint32_t y, const uint32_t z) const {
+        flushBarriers();
         vkCmdDispatch(commandBuffer, x, y, z);
     }
 
@@ -676,14 +800,16 @@ namespace vireo {
         const ResourceState newState,
         const uint32_t firstMipLevel,
         const uint32_t levelCount) const {
-        VkPipelineStageFlags srcStage, dstStage;
-        VkAccessFlags srcAccess, dstAccess;
+        VkPipelineStageFlags2 srcStage, dstStage;
+        VkAccessFlags2 srcAccess, dstAccess;
         VkImageLayout srcLayout, dstLayout;
         VkImageAspectFlagBits aspectFlag = VK_IMAGE_ASPECT_COLOR_BIT;
         convertState(oldState, newState, srcStage, dstStage, srcAccess, dstAccess, srcLayout, dstLayout, aspectFlag);
-        const auto barrier = VkImageMemoryBarrier {
-            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        addBarrier(VkImageMemoryBarrier2 {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+            .srcStageMask = srcStage,
             .srcAccessMask =  srcAccess,
+            .dstStageMask = dstStage,
             .dstAccessMask = dstAccess,
             .oldLayout = srcLayout,
             .newLayout = dstLayout,
@@ -697,17 +823,7 @@ namespace vireo {
                 .baseArrayLayer = 0,
                 .layerCount = VK_REMAINING_ARRAY_LAYERS,
             }
-        };
-        vkCmdPipelineBarrier(commandBuffer,
-            srcStage,
-            dstStage,
-            0,
-            0,
-            nullptr,
-            0,
-            nullptr,
-            1,
-            &barrier);
+        });
     }
 
     void VKCommandList::barrier(
@@ -715,8 +831,8 @@ namespace vireo {
         const ResourceState oldState,
         const ResourceState newState) const {
         assert(!images.empty());
-        VkPipelineStageFlags srcStage, dstStage;
-        VkAccessFlags srcAccess, dstAccess;
+        VkPipelineStageFlags2 srcStage, dstStage;
+        VkAccessFlags2 srcAccess, dstAccess;
         VkImageLayout srcLayout, dstLayout;
         VkImageAspectFlagBits aspectFlag = VK_IMAGE_ASPECT_COLOR_BIT;
         convertState(
@@ -726,71 +842,66 @@ namespace vireo {
             srcLayout, dstLayout,
             aspectFlag);
 
-        std::vector<VkImageMemoryBarrier> barriers(images.size());
-        for (int i = 0; i < images.size(); i++) {
-            barriers[i].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-            barriers[i].srcAccessMask =  srcAccess;
-            barriers[i].dstAccessMask = dstAccess;
-            barriers[i].oldLayout = srcLayout;
-            barriers[i].newLayout = dstLayout;
-            barriers[i].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            barriers[i].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            barriers[i].image = images[i];
-            barriers[i].subresourceRange.aspectMask = static_cast<uint32_t>(aspectFlag);
-            barriers[i].subresourceRange.baseMipLevel = 0;
-            barriers[i].subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
-            barriers[i].subresourceRange.baseArrayLayer = 0;
-            barriers[i].subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
-        }
-        vkCmdPipelineBarrier(commandBuffer,
-            srcStage,
-            dstStage,
-            0,
-            0,
-            nullptr,
-            0,
-            nullptr,
-            barriers.size(),
-            barriers.data());
+        for (const auto image : images) {
+            addBarrier(VkImageMemoryBarrier2 {
+                .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+                .srcStageMask = srcStage,
+                .srcAccessMask =  srcAccess,
+                .dstStageMask = dstStage,
+                .dstAccessMask = dstAccess,
+                .oldLayout = srcLayout,
+                .newLayout = dstLayout,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .image = image,
+                .subresourceRange = {
+                    .aspectMask = static_cast<uint32_t>(aspectFlag),
+                    .baseMipLevel = 0,
+                    .levelCount = VK_REMAINING_MIP_LEVELS,
+                    .baseArrayLayer = 0,
+                    .layerCount = VK_REMAINING_ARRAY_LAYERS,
+                }
+            });
+        }
     }
 
     void VKCommandList::convertState(
             const ResourceState oldState,
             const ResourceState newState,
-            VkPipelineStageFlags& srcStage,
-            VkPipelineStageFlags& dstStage,
-            VkAccessFlags& srcAccess,
-            VkAccessFlags& dstAccess,
+            VkPipelineStageFlags2& srcStage,
+            VkPipelineStageFlags2& dstStage,
+            VkAccessFlags2& srcAccess,
+            VkAccessFlags2& dstAccess,
             VkImageLayout& srcLayout,
             VkImageLayout& dstLayout,
             VkImageAspectFlagBits& aspectFlag) {
         if (oldState == ResourceState::UNDEFINED && newState == ResourceState::DISPATCH_TARGET) {
-            srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-            dstStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
-            srcAccess = 0;
-            dstAccess = VK_ACCESS_SHADER_WRITE_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_NONE;
+            dstStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+            srcAccess = VK_ACCESS_2_NONE;
+            dstAccess = VK_ACCESS_2_SHADER_WRITE_BIT;
             srcLayout = VK_IMAGE_LAYOUT_UNDEFINED;
             dstLayout = VK_IMAGE_LAYOUT_GENERAL;
         } else if (oldState == ResourceState::UNDEFINED && newState == ResourceState::RENDER_TARGET_COLOR) {
-            srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-            dstStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-            srcAccess = 0;
-            dstAccess = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_NONE;
+            dstStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+            srcAccess = VK_ACCESS_2_NONE;
+            dstAccess = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
             srcLayout = VK_IMAGE_LAYOUT_UNDEFINED;
             dstLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
         } else if (oldState == ResourceState::SHADER_READ && newState == ResourceState::RENDER_TARGET_COLOR) {
-            srcStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-            dstStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-            srcAccess = VK_ACCESS_SHADER_READ_BIT;
-            dstAccess = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+            srcAccess = VK_ACCESS_2_SHADER_READ_BIT;
+            dstAccess = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
             srcLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
             dstLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
         } else if (oldState == ResourceState::UNDEFINED &&
                   (newState == ResourceState::RENDER_TARGET_DEPTH_STENCIL || newState == ResourceState::RENDER_TARGET_DEPTH)) {
-            srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-            dstStage = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
-            srcAccess = 0;
-            dstAccess = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_NONE;
+            dstStage = VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+            srcAccess = VK_ACCESS_2_NONE;
+            dstAccess = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
             srcLayout = VK_IMAGE_LAYOUT_UNDEFINED;
             dstLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
             aspectFlag = newState == ResourceState::RENDER_TARGET_DEPTH ?
@@ -798,10 +909,10 @@ namespace vireo {
                 static_cast<VkImageAspectFlagBits>(VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT);
         } else if ((oldState == ResourceState::RENDER_TARGET_DEPTH_STENCIL || oldState == ResourceState::RENDER_TARGET_DEPTH) &&
                    (newState == ResourceState::RENDER_TARGET_DEPTH_STENCIL_READ || newState == ResourceState::RENDER_TARGET_DEPTH_READ)) {
-            srcStage = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
-            dstStage = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-            srcAccess = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-            dstAccess = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT;
+            srcAccess = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            dstAccess = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
             srcLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
             dstLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
             aspectFlag = (newState == ResourceState::RENDER_TARGET_DEPTH_READ || oldState == ResourceState::RENDER_TARGET_DEPTH) ?
@@ -809,10 +920,10 @@ namespace vireo {
                 static_cast<VkImageAspectFlagBits>(VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT);
         } else if ((oldState == ResourceState::RENDER_TARGET_DEPTH_STENCIL_READ || oldState == ResourceState::RENDER_TARGET_DEPTH_READ) &&
                    (newState == ResourceState::RENDER_TARGET_DEPTH_STENCIL || newState == ResourceState::RENDER_TARGET_DEPTH)) {
-            srcStage = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
-            dstStage = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
-            srcAccess = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
-            dstAccess = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+            srcAccess = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+            dstAccess = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
             srcLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
             dstLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
             aspectFlag = (oldState == ResourceState::RENDER_TARGET_DEPTH_READ || newState == ResourceState::RENDER_TARGET_DEPTH)?
@@ -820,154 +931,154 @@ namespace vireo {
                 static_cast<VkImageAspectFlagBits>(VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT);
         } else if (oldState == ResourceState::UNDEFINED &&
             (newState == ResourceState::RENDER_TARGET_DEPTH_STENCIL_READ || newState == ResourceState::RENDER_TARGET_DEPTH_READ)) {
-            srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-            dstStage = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-            srcAccess = 0;
-            dstAccess = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_NONE;
+            dstStage = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT;
+            srcAccess = VK_ACCESS_2_NONE;
+            dstAccess = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
             srcLayout = VK_IMAGE_LAYOUT_UNDEFINED;
             dstLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
             aspectFlag = newState == ResourceState::RENDER_TARGET_DEPTH_READ ?
                 VK_IMAGE_ASPECT_DEPTH_BIT :
                 static_cast<VkImageAspectFlagBits>(VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT);
         } else if (oldState == ResourceState::RENDER_TARGET_COLOR && newState == ResourceState::COPY_SRC) {
-            srcStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-            dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            srcAccess = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-            dstAccess = 0;
+            srcStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            srcAccess = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
+            dstAccess = VK_ACCESS_2_NONE;
             srcLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
             dstLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
         } else if (oldState == ResourceState::RENDER_TARGET_COLOR && newState == ResourceState::COMPUTE_READ) {
-            srcStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-            dstStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
-            srcAccess = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-            dstAccess = VK_ACCESS_SHADER_READ_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+            srcAccess = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
+            dstAccess = VK_ACCESS_2_SHADER_READ_BIT;
             srcLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
             dstLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
         } else if (oldState == ResourceState::RENDER_TARGET_COLOR && newState == ResourceState::SHADER_READ) {
-            srcStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-            dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-            srcAccess = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-            dstAccess = VK_ACCESS_SHADER_READ_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+            srcAccess = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
+            dstAccess = VK_ACCESS_2_SHADER_READ_BIT;
             srcLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
             dstLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
         } else if (oldState == ResourceState::SHADER_READ && newState == ResourceState::UNDEFINED) {
-            srcStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-            dstStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-            srcAccess = VK_ACCESS_SHADER_READ_BIT;
-            dstAccess = 0;
+            srcStage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_NONE;
+            srcAccess = VK_ACCESS_2_SHADER_READ_BIT;
+            dstAccess = VK_ACCESS_2_NONE;
             srcLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
             dstLayout = VK_IMAGE_LAYOUT_GENERAL;
         } else if (oldState == ResourceState::COMPUTE_READ && newState == ResourceState::UNDEFINED) {
-            srcStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
-            dstStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-            srcAccess = VK_ACCESS_SHADER_READ_BIT;
-            dstAccess = 0;
+            srcStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_NONE;
+            srcAccess = VK_ACCESS_2_SHADER_READ_BIT;
+            dstAccess = VK_ACCESS_2_NONE;
             srcLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
             dstLayout = VK_IMAGE_LAYOUT_GENERAL;
         } else if (oldState == ResourceState::COMPUTE_READ && newState == ResourceState::COPY_SRC) {
-            srcStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
-            dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            srcAccess = VK_ACCESS_SHADER_READ_BIT;
-            dstAccess = VK_ACCESS_TRANSFER_READ_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            srcAccess = VK_ACCESS_2_SHADER_READ_BIT;
+            dstAccess = VK_ACCESS_2_TRANSFER_READ_BIT;
             srcLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
             dstLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
         } else if (oldState == ResourceState::COMPUTE_READ && newState == ResourceState::UNDEFINED) {
-            srcStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
-            dstStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-            srcAccess = VK_ACCESS_SHADER_READ_BIT;
-            dstAccess = 0;
+            srcStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_NONE;
+            srcAccess = VK_ACCESS_2_SHADER_READ_BIT;
+            dstAccess = VK_ACCESS_2_NONE;
             srcLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
             dstLayout = VK_IMAGE_LAYOUT_GENERAL;
         } else if (oldState == ResourceState::RENDER_TARGET_COLOR && newState == ResourceState::PRESENT) {
-            srcStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-            dstStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-            srcAccess = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-            dstAccess = 0;
+            srcStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_NONE;
+            srcAccess = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
+            dstAccess = VK_ACCESS_2_NONE;
             srcLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
             dstLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
         } else if (oldState == ResourceState::UNDEFINED && newState == ResourceState::PRESENT) {
-            srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-            dstStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-            srcAccess = 0;
-            dstAccess = 0;
+            srcStage = VK_PIPELINE_STAGE_2_NONE;
+            dstStage = VK_PIPELINE_STAGE_2_NONE;
+            srcAccess = VK_ACCESS_2_NONE;
+            dstAccess = VK_ACCESS_2_NONE;
             srcLayout = VK_IMAGE_LAYOUT_UNDEFINED;
             dstLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
         } else if (oldState == ResourceState::COPY_DST && newState == ResourceState::PRESENT) {
-            srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            dstStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-            srcAccess = VK_ACCESS_TRANSFER_WRITE_BIT;
-            dstAccess = 0;
+            srcStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_NONE;
+            srcAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+            dstAccess = VK_ACCESS_2_NONE;
             srcLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
             dstLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
         } else if (oldState == ResourceState::UNDEFINED && newState == ResourceState::COPY_DST) {
-            srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            srcAccess = 0;
-            dstAccess = VK_ACCESS_TRANSFER_WRITE_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            srcAccess = VK_ACCESS_2_NONE;
+            dstAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT;
             srcLayout = VK_IMAGE_LAYOUT_UNDEFINED;
             dstLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
         } else if (oldState == ResourceState::UNDEFINED && newState == ResourceState::SHADER_READ) {
-            srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-            dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-            srcAccess = 0;
-            dstAccess = VK_ACCESS_SHADER_READ_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_NONE;
+            dstStage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+            srcAccess = VK_ACCESS_2_NONE;
+            dstAccess = VK_ACCESS_2_SHADER_READ_BIT;
             srcLayout = VK_IMAGE_LAYOUT_UNDEFINED;
             dstLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
         } else if (oldState == ResourceState::COPY_DST && newState == ResourceState::SHADER_READ) {
-            srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-            srcAccess = VK_ACCESS_TRANSFER_WRITE_BIT;
-            dstAccess = VK_ACCESS_SHADER_READ_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+            srcAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+            dstAccess = VK_ACCESS_2_SHADER_READ_BIT;
             srcLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
             dstLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
         } else if (oldState == ResourceState::COPY_SRC && newState == ResourceState::SHADER_READ) {
-            srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-            srcAccess = VK_ACCESS_TRANSFER_READ_BIT;
-            dstAccess = VK_ACCESS_SHADER_READ_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+            srcAccess = VK_ACCESS_2_TRANSFER_READ_BIT;
+            dstAccess = VK_ACCESS_2_SHADER_READ_BIT;
             srcLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
             dstLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
         } else if (oldState == ResourceState::DISPATCH_TARGET && newState == ResourceState::COPY_SRC) {
-            srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            srcAccess = 0;
-            dstAccess = VK_ACCESS_TRANSFER_READ_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            srcAccess = VK_ACCESS_2_NONE;
+            dstAccess = VK_ACCESS_2_TRANSFER_READ_BIT;
             srcLayout = VK_IMAGE_LAYOUT_GENERAL;
             dstLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
         } else if (oldState == ResourceState::UNDEFINED && newState == ResourceState::COPY_SRC) {
-            srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-            dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            srcAccess = 0;
-            dstAccess = VK_ACCESS_TRANSFER_READ_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_NONE;
+            dstStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            srcAccess = VK_ACCESS_2_NONE;
+            dstAccess = VK_ACCESS_2_TRANSFER_READ_BIT;
             srcLayout = VK_IMAGE_LAYOUT_UNDEFINED;
             dstLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
         } else if (oldState == ResourceState::COPY_SRC && newState == ResourceState::UNDEFINED) {
-            srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            srcAccess = VK_ACCESS_TRANSFER_READ_BIT;
-            dstAccess = 0;
+            srcStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            srcAccess = VK_ACCESS_2_TRANSFER_READ_BIT;
+            dstAccess = VK_ACCESS_2_NONE;
             srcLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
             dstLayout = VK_IMAGE_LAYOUT_GENERAL;
         } else if (oldState == ResourceState::RENDER_TARGET_COLOR && newState == ResourceState::UNDEFINED) {
-            srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            dstStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-            srcAccess = 0;
-            dstAccess = 0;
+            srcStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_NONE;
+            srcAccess = VK_ACCESS_2_NONE;
+            dstAccess = VK_ACCESS_2_NONE;
             srcLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
             dstLayout = VK_IMAGE_LAYOUT_GENERAL;
         } else if (oldState == ResourceState::DISPATCH_TARGET && newState == ResourceState::UNDEFINED) {
-            srcStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
-            dstStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-            srcAccess = 0;
-            dstAccess = 0;
+            srcStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_NONE;
+            srcAccess = VK_ACCESS_2_NONE;
+            dstAccess = VK_ACCESS_2_NONE;
             srcLayout = VK_IMAGE_LAYOUT_GENERAL;
             dstLayout = VK_IMAGE_LAYOUT_GENERAL;
         } else if ((oldState == ResourceState::RENDER_TARGET_DEPTH_STENCIL || oldState == ResourceState::RENDER_TARGET_DEPTH) &&
                    newState == ResourceState::UNDEFINED) {
-            srcStage = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
-            dstStage = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-            srcAccess = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-            dstAccess = 0;
+            srcStage = VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT;
+            srcAccess = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            dstAccess = VK_ACCESS_2_NONE;
             srcLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
             dstLayout = VK_IMAGE_LAYOUT_GENERAL;
             aspectFlag = oldState == ResourceState::RENDER_TARGET_DEPTH ?
@@ -975,55 +1086,55 @@ namespace vireo {
                 static_cast<VkImageAspectFlagBits>(VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT);
         } else if ((oldState == ResourceState::RENDER_TARGET_DEPTH_STENCIL_READ || oldState == ResourceState::RENDER_TARGET_DEPTH_READ) &&
                     newState == ResourceState::UNDEFINED) {
-            srcStage = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
-            dstStage = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-            srcAccess = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
-            dstAccess = 0;
+            srcStage = VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT;
+            srcAccess = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+            dstAccess = VK_ACCESS_2_NONE;
             srcLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
             dstLayout = VK_IMAGE_LAYOUT_GENERAL;
             aspectFlag = oldState == ResourceState::RENDER_TARGET_DEPTH_READ ?
                 VK_IMAGE_ASPECT_DEPTH_BIT :
                 static_cast<VkImageAspectFlagBits>(VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT);
         } else if (oldState == ResourceState::COPY_SRC && newState == ResourceState::DISPATCH_TARGET) {
-            srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            dstStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
-            srcAccess = VK_ACCESS_TRANSFER_READ_BIT;
-            dstAccess = VK_ACCESS_SHADER_WRITE_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+            srcAccess = VK_ACCESS_2_TRANSFER_READ_BIT;
+            dstAccess = VK_ACCESS_2_SHADER_WRITE_BIT;
             srcLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
             dstLayout = VK_IMAGE_LAYOUT_GENERAL;
         } else if (oldState == ResourceState::COPY_SRC && newState == ResourceState::RENDER_TARGET_COLOR) {
-            srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            dstStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-            srcAccess = 0;
-            dstAccess = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+            srcAccess = VK_ACCESS_2_NONE;
+            dstAccess = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
             srcLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
             dstLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
         } else if (oldState == ResourceState::COPY_SRC && newState == ResourceState::COPY_DST) {
-            srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            srcAccess = VK_ACCESS_TRANSFER_READ_BIT;
-            dstAccess = VK_ACCESS_TRANSFER_WRITE_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            srcAccess = VK_ACCESS_2_TRANSFER_READ_BIT;
+            dstAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT;
             srcLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
             dstLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
         } else if (oldState == ResourceState::COPY_DST && newState == ResourceState::COPY_SRC) {
-            srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            srcAccess = VK_ACCESS_TRANSFER_WRITE_BIT;
-            dstAccess = VK_ACCESS_TRANSFER_READ_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            srcAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+            dstAccess = VK_ACCESS_2_TRANSFER_READ_BIT;
             srcLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
             dstLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
         } else if (oldState == ResourceState::SHADER_READ && newState == ResourceState::COPY_SRC) {
-            srcStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-            dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            srcAccess = VK_ACCESS_SHADER_READ_BIT;
-            dstAccess = VK_ACCESS_TRANSFER_READ_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            srcAccess = VK_ACCESS_2_SHADER_READ_BIT;
+            dstAccess = VK_ACCESS_2_TRANSFER_READ_BIT;
             srcLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
             dstLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
         } else if (oldState == ResourceState::COPY_DST && newState == ResourceState::UNDEFINED) {
-            srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            srcAccess = VK_ACCESS_TRANSFER_WRITE_BIT;
-            dstAccess = 0;
+            srcStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            srcAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+            dstAccess = VK_ACCESS_2_NONE;
             srcLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
             dstLayout = VK_IMAGE_LAYOUT_GENERAL;
         } else {
@@ -1034,80 +1145,81 @@ namespace vireo {
     void VKCommandList::convertState(
         const ResourceState oldState,
         const ResourceState newState,
-        VkPipelineStageFlags& srcStage,
-        VkPipelineStageFlags& dstStage,
-        VkAccessFlags& srcAccess,
-        VkAccessFlags& dstAccess) {
+        VkPipelineStageFlags2& srcStage,
+        VkPipelineStageFlags2& dstStage,
+        VkAccessFlags2& srcAccess,
+        VkAccessFlags2& dstAccess) {
         if (oldState == ResourceState::INDIRECT_DRAW && newState == ResourceState::COMPUTE_WRITE) {
-            srcStage = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
-            dstStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
-            srcAccess = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
-            dstAccess = VK_ACCESS_SHADER_WRITE_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+            srcAccess = VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT;
+            dstAccess = VK_ACCESS_2_SHADER_WRITE_BIT;
         }else if (oldState == ResourceState::INDIRECT_DRAW && newState == ResourceState::COPY_DST) {
-            srcStage = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
-            dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            srcAccess = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
-            dstAccess = VK_ACCESS_TRANSFER_WRITE_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            srcAccess = VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT;
+            dstAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT;
         } else if (oldState == ResourceState::COMPUTE_WRITE && newState == ResourceState::INDIRECT_DRAW){
-            srcStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
-            dstStage = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
-            srcAccess = VK_ACCESS_SHADER_WRITE_BIT;
-            dstAccess = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT;
+            srcAccess = VK_ACCESS_2_SHADER_WRITE_BIT;
+            dstAccess = VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT;
         } else if (oldState == ResourceState::COPY_DST && newState == ResourceState::COMPUTE_WRITE) {
-            srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            dstStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
-            srcAccess = VK_ACCESS_TRANSFER_WRITE_BIT;
-            dstAccess = VK_ACCESS_SHADER_WRITE_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+            srcAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+            dstAccess = VK_ACCESS_2_SHADER_WRITE_BIT;
         } else if (oldState == ResourceState::COPY_DST && newState == ResourceState::SHADER_READ) {
-            srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            dstStage = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT;
-            srcAccess = VK_ACCESS_TRANSFER_WRITE_BIT;
-            dstAccess = VK_ACCESS_SHADER_READ_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT;
+            srcAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+            dstAccess = VK_ACCESS_2_SHADER_READ_BIT;
         } else if (oldState == ResourceState::SHADER_READ && newState == ResourceState::COPY_DST) {
-            srcStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
-            dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            srcAccess = VK_ACCESS_SHADER_READ_BIT;
-            dstAccess = VK_ACCESS_TRANSFER_WRITE_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            srcAccess = VK_ACCESS_2_SHADER_READ_BIT;
+            dstAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT;
         } else if (oldState == ResourceState::COPY_SRC && newState == ResourceState::COMPUTE_WRITE) {
-            srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            dstStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
-            srcAccess = VK_ACCESS_TRANSFER_READ_BIT;
-            dstAccess = VK_ACCESS_SHADER_WRITE_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+            srcAccess = VK_ACCESS_2_TRANSFER_READ_BIT;
+            dstAccess = VK_ACCESS_2_SHADER_WRITE_BIT;
         } else if (oldState == ResourceState::SHADER_READ && newState == ResourceState::COMPUTE_WRITE) {
-            srcStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
-            dstStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
-            srcAccess = VK_ACCESS_TRANSFER_READ_BIT;
-            dstAccess = VK_ACCESS_SHADER_WRITE_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+            srcAccess = VK_ACCESS_2_TRANSFER_READ_BIT;
+            dstAccess = VK_ACCESS_2_SHADER_WRITE_BIT;
         } else if (oldState == ResourceState::COMPUTE_WRITE && newState == ResourceState::COPY_SRC) {
-            srcStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
-            dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            srcAccess = VK_ACCESS_SHADER_WRITE_BIT;
-            dstAccess = VK_ACCESS_TRANSFER_READ_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            srcAccess = VK_ACCESS_2_SHADER_WRITE_BIT;
+            dstAccess = VK_ACCESS_2_TRANSFER_READ_BIT;
         } else if (oldState == ResourceState::COMPUTE_WRITE && newState == ResourceState::SHADER_READ) {
-            srcStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
-            dstStage = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT;
-            srcAccess = VK_ACCESS_SHADER_WRITE_BIT;
-            dstAccess = VK_ACCESS_SHADER_READ_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT;
+            srcAccess = VK_ACCESS_2_SHADER_WRITE_BIT;
+            dstAccess = VK_ACCESS_2_SHADER_READ_BIT;
         } else if (oldState == ResourceState::COPY_DST && newState == ResourceState::SHADER_READ) {
-            srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            dstStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-            srcAccess = VK_ACCESS_TRANSFER_WRITE_BIT;
-            dstAccess = VK_ACCESS_SHADER_READ_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+            srcAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+            dstAccess = VK_ACCESS_2_SHADER_READ_BIT;
         } else if (oldState == ResourceState::COPY_DST && newState == ResourceState::INDIRECT_DRAW) {
-            srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            dstStage = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
-            srcAccess = VK_ACCESS_TRANSFER_WRITE_BIT;
-            dstAccess = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT;
+            srcAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+            dstAccess = VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT;
         } else if (oldState == ResourceState::COPY_DST && newState == ResourceState::VERTEX_INPUT) {
-            srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            dstStage = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
-            srcAccess = VK_ACCESS_TRANSFER_WRITE_BIT;
-            dstAccess = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            dstStage = VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT;
+            srcAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+            dstAccess = VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT;
         } else if (oldState == ResourceState::COPY_DST && newState == ResourceState::UNIFORM) {
-            srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            dstStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-            srcAccess = VK_ACCESS_TRANSFER_WRITE_BIT;
-            dstAccess = VK_ACCESS_UNIFORM_READ_BIT;
+            srcStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            // The uniform buffers are read by any shader stage
+            dstStage = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+            srcAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+            dstAccess = VK_ACCESS_2_UNIFORM_READ_BIT;
         } else {
             throw Exception("Not implemented");
         }
@@ -1117,28 +1229,152 @@ namespace vireo {
         const Buffer& buffer,
         const ResourceState oldState,
         const ResourceState newState) const {
-        VkPipelineStageFlags srcStage, dstStage;
-        VkAccessFlags srcAccess, dstAccess;
+        VkPipelineStageFlags2 srcStage, dstStage;
+        VkAccessFlags2 srcAccess, dstAccess;
         convertState(oldState, newState, srcStage, dstStage, srcAccess, dstAccess);
-        const auto bufferBarrier = VkBufferMemoryBarrier {
-            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+        addBarrier(VkBufferMemoryBarrier2 {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+            .srcStageMask = srcStage,
             .srcAccessMask = srcAccess,
+            .dstStageMask = dstStage,
             .dstAccessMask = dstAccess,
             .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
             .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
             .buffer = static_cast<const VKBuffer&>(buffer).getBuffer(),
             .offset = 0,
             .size = VK_WHOLE_SIZE,
+        });
+    }
+
+    void VKCommandList::barrier(
+        const std::shared_ptr<const Image>& before,
+        const std::shared_ptr<const Image>& after) const {
+        assert(after != nullptr);
+        aliasingBarrier();
+    }
+
+    void VKCommandList::barrier(
+        const Buffer& before,
+        const Buffer& after) const {
+        aliasingBarrier();
+    }
+
+    void VKCommandList::transferOwnership(
+        const Buffer& buffer,
+        const CommandType source,
+        const CommandType destination,
+        const size_t offset,
+        const size_t size) const {
+        const auto srcQueueFamilyIndex = device->getQueueFamilyIndex(source);
+        const auto dstQueueFamilyIndex = device->getQueueFamilyIndex(destination);
+        if (srcQueueFamilyIndex == dstQueueFamilyIndex) { return; }
+        // The release ignores the destination stages & accesses and the acquire the source ones,
+        // so the same barrier is recorded on both queues
+        addBarrier(VkBufferMemoryBarrier2 {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+            .srcStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+            .srcAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT,
+            .dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+            .dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT,
+            .srcQueueFamilyIndex = srcQueueFamilyIndex,
+            .dstQueueFamilyIndex = dstQueueFamilyIndex,
+            .buffer = static_cast<const VKBuffer&>(buffer).getBuffer(),
+            .offset = offset,
+            .size = size == Buffer::WHOLE_SIZE ? VK_WHOLE_SIZE : size,
+        });
+    }
+
+    void VKCommandList::transferOwnership(
+        const Image& image,
+        const CommandType source,
+        const CommandType destination,
+        const uint32_t mipLevel,
+        const uint32_t arrayLayer) const {
+        assert(mipLevel < image.getMipLevels());
+        assert(arrayLayer < image.getArraySize());
+        const auto srcQueueFamilyIndex = device->getQueueFamilyIndex(source);
+        const auto dstQueueFamilyIndex = device->getQueueFamilyIndex(destination);
+        if (srcQueueFamilyIndex == dstQueueFamilyIndex) { return; }
+        addBarrier(VkImageMemoryBarrier2 {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+            .srcStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+            .srcAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT,
+            .dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+            .dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT,
+            .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            .srcQueueFamilyIndex = srcQueueFamilyIndex,
+            .dstQueueFamilyIndex = dstQueueFamilyIndex,
+            .image = static_cast<const VKImage&>(image).getImage(),
+            .subresourceRange = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .baseMipLevel = mipLevel,
+                .levelCount = 1,
+                .baseArrayLayer = arrayLayer,
+                .layerCount = 1,
+            },
+        });
+    }
+
+    void VKCommandList::aliasingBarrier() const {
+        // Vulkan have no per-resource aliasing barrier, the new resource layout
+        // is transitioned from UNDEFINED by the application.
+        // The transitions of the previous resource must be done before, and the ones of the new resource after
+        flushBarriers();
+        const auto memoryBarrier = VkMemoryBarrier2 {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+            .srcStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+            .srcAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT,
+            .dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+            .dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT,
         };
-        vkCmdPipelineBarrier(
-            commandBuffer,
-            srcStage,
-            dstStage,
-            0,
-            0, nullptr,
-            1, &bufferBarrier,
-            0, nullptr
-        );
+        const auto dependencyInfo = VkDependencyInfo {
+            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+            .memoryBarrierCount = 1,
+            .pMemoryBarriers = &memoryBarrier,
+        };
+        vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+    }
+
+    void VKCommandList::addBarrier(const VkImageMemoryBarrier2& barrier) const {
+        const auto levelsEnd = [](const VkImageSubresourceRange& range) {
+            return range.levelCount == VK_REMAINING_MIP_LEVELS ?
+                std::numeric_limits<uint32_t>::max() :
+                range.baseMipLevel + range.levelCount;
+        };
+        // Two transitions of the same subresources in one vkCmdPipelineBarrier2 are not ordered
+        if (std::ranges::any_of(pendingImageBarriers, [&](const VkImageMemoryBarrier2& pending) {
+            return pending.image == barrier.image &&
+                pending.subresourceRange.baseMipLevel < levelsEnd(barrier.subresourceRange) &&
+                barrier.subresourceRange.baseMipLevel < levelsEnd(pending.subresourceRange);
+        })) {
+            flushBarriers();
+        }
+        pendingImageBarriers.push_back(barrier);
+    }
+
+    void VKCommandList::addBarrier(const VkBufferMemoryBarrier2& barrier) const {
+        if (std::ranges::any_of(pendingBufferBarriers, [&](const VkBufferMemoryBarrier2& pending) {
+            return pending.buffer == barrier.buffer;
+        })) {
+            flushBarriers();
+        }
+        pendingBufferBarriers.push_back(barrier);
+    }
+
+    void VKCommandList::flushBarriers() const {
+        if (pendingImageBarriers.empty() && pendingBufferBarriers.empty()) { return; }
+        const auto dependencyInfo = VkDependencyInfo {
+            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+            .bufferMemoryBarrierCount = static_cast<uint32_t>(pendingBufferBarriers.size()),
+            .pBufferMemoryBarriers = pendingBufferBarriers.empty() ? nullptr : pendingBufferBarriers.data(),
+            .imageMemoryBarrierCount = static_cast<uint32_t>(pendingImageBarriers.size()),
+            .pImageMemoryBarriers = pendingImageBarriers.empty() ? nullptr : pendingImageBarriers.data(),
+        };
+        vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+        // Keep the capacity, the next barriers don't allocate
+        pendingImageBarriers.clear();
+        pendingBufferBarriers.clear();
     }
 
     void VKCommandList::barrier(
@@ -1202,65 +1438,340 @@ namespace vireo {
             data);
     }
 
-    void VKCommandList::begin() const {
-        constexpr auto beginInfo = VkCommandBufferBeginInfo{
+    void VKCommandList::begin(const CommandListUsage usage) const {
+        // Secondary command buffers used outside a render pass inherit nothing
+        constexpr auto inheritanceInfo = VkCommandBufferInheritanceInfo {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+        };
+        const auto beginInfo = VkCommandBufferBeginInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .flags = vkUsages[static_cast<int>(usage)],
+            .pInheritanceInfo = secondary ? &inheritanceInfo : nullptr,
+        };
+        beginCommandBuffer(beginInfo);
+    }
+
+    void VKCommandList::begin(const RenderingConfiguration& conf, const CommandListUsage usage) const {
+        assert(secondary);
+        // The formats & samples of the attachments used by beginRendering()
+        auto samples = VK_SAMPLE_COUNT_1_BIT;
+        auto colorFormats = std::vector<VkFormat>(conf.colorRenderTargets.size(), VK_FORMAT_UNDEFINED);
+        for (int i = 0; i < conf.colorRenderTargets.size(); i++) {
+            const auto& target = conf.colorRenderTargets[i];
+            if (target.multisampledRenderTarget) {
+                const auto msaaColor = static_pointer_cast<VKImage>(target.multisampledRenderTarget->getImage());
+                colorFormats[i] = VKImage::vkFormats[static_cast<int>(msaaColor->getFormat())];
+                samples = msaaColor->getSamples();
+            } else if (target.swapChain) {
+                colorFormats[i] = static_pointer_cast<VKSwapChain>(target.swapChain)->getImageFormat();
+            } else if (target.renderTarget) {
+                const auto vkColorImage = static_pointer_cast<VKImage>(target.renderTarget->getImage());
+                colorFormats[i] = VKImage::vkFormats[static_cast<int>(vkColorImage->getFormat())];
+                samples = vkColorImage->getSamples();
+            }
+        }
+        auto depthStencilFormat = VK_FORMAT_UNDEFINED;
+        if (conf.depthStencilRenderTarget && (conf.depthTestEnable || conf.stencilTestEnable)) {
+            const auto vkDepthImage = static_pointer_cast<VKImage>(conf.multisampledDepthStencilRenderTarget ?
+                conf.multisampledDepthStencilRenderTarget->getImage() :
+                conf.depthStencilRenderTarget->getImage());
+            depthStencilFormat = VKImage::vkFormats[static_cast<int>(vkDepthImage->getFormat())];
+            samples = vkDepthImage->getSamples();
+        }
+        const auto renderingInfo = VkCommandBufferInheritanceRenderingInfo {
+            .sType                   = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO,
+            .colorAttachmentCount    = static_cast<uint32_t>(colorFormats.size()),
+            .pColorAttachmentFormats = colorFormats.empty() ? nullptr : colorFormats.data(),
+            .depthAttachmentFormat   = conf.depthTestEnable ? depthStencilFormat : VK_FORMAT_UNDEFINED,
+            .stencilAttachmentFormat = conf.stencilTestEnable ? depthStencilFormat : VK_FORMAT_UNDEFINED,
+            .rasterizationSamples    = samples,
+        };
+        const auto inheritanceInfo = VkCommandBufferInheritanceInfo {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+            .pNext = &renderingInfo,
+        };
+        const auto beginInfo = VkCommandBufferBeginInfo{
             .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | vkUsages[static_cast<int>(usage)],
+            .pInheritanceInfo = &inheritanceInfo,
         };
+        beginCommandBuffer(beginInfo);
+    }
+
+    void VKCommandList::beginCommandBuffer(const VkCommandBufferBeginInfo& beginInfo) const {
+        // The previous recording can still be executing, the ring waits for its submissions
+        releaseStaging();
         vkResetCommandBuffer(commandBuffer, 0);
         vkCheck(vkBeginCommandBuffer(commandBuffer, &beginInfo));
+        // A new command buffer recording starts with an undefined state
+        shadowState = {};
+        skippedStateCount = 0;
+        pendingImageBarriers.clear();
+        pendingBufferBarriers.clear();
     }
 
     void VKCommandList::end() const {
+        flushBarriers();
         vkCheck(vkEndCommandBuffer(commandBuffer));
     }
 
     void VKCommandList::cleanup() {
+        releaseStaging();
         stagingBuffers.clear();
     }
 
-    void VKCommandList::upload(const Buffer& destination, const void* source) {
-        assert(source != nullptr);
-        const auto& buffer = static_cast<const VKBuffer&>(destination);
-        const auto stagingBuffer = std::make_shared<VKBuffer>(
-            device,
-            BufferType::BUFFER_UPLOAD,
-            buffer.getInstanceSize(),
-            buffer.getInstanceCount(),
-            L"StagingBuffer for buffer");
+    VKStagingAllocation VKCommandList::allocateStaging(
+        const VkDeviceSize size,
+        const std::wstring& name,
+        const VkDeviceSize alignment) {
+        if (const auto allocation = device->getStagingRing().allocate(size, alignment)) {
+            stagingAllocations.push_back(*allocation);
+            return *allocation;
+        }
+        // The ring is full or too small, fall back to a temporary buffer
+        const auto stagingBuffer = std::make_shared<VKBuffer>(device, BufferType::BUFFER_UPLOAD, size, 1, name);
         stagingBuffer->map();
-        if ((buffer.getInstanceSizeAligned() == 1) || (buffer.getInstanceCount() == 1)) {
-            stagingBuffer->write(source);
-        } else {
-            for (int i = 0; i < buffer.getInstanceCount(); i++) {
-                stagingBuffer->write(
-                    static_cast<const unsigned char*>(source) + i * buffer.getInstanceSize(),
-                    buffer.getInstanceSize(),
-                    buffer.getInstanceSizeAligned() * i);
+        stagingBuffers.push_back(stagingBuffer);
+        return {
+            .buffer = stagingBuffer->getBuffer(),
+            .offset = 0,
+            .size = size,
+            .mappedAddress = stagingBuffer->getMappedAddress(),
+        };
+    }
+
+    void VKCommandList::releaseStaging() const {
+        for (const auto& allocation : stagingAllocations) {
+            device->getStagingRing().release(allocation);
+        }
+        stagingAllocations.clear();
+    }
+
+    void VKCommandList::retireStaging(const VkSemaphore semaphore, const uint64_t value) const {
+        // A recording can be submitted many times, the ranges stay in the list until the next begin()
+        for (const auto& allocation : stagingAllocations) {
+            device->getStagingRing().retire(allocation, semaphore, value);
+        }
+    }
+
+    bool VKCommandList::updateDescriptorSets(
+        const VkPipelineBindPoint bindPoint,
+        const uint32_t firstSet,
+        const uint32_t count,
+        const VkDescriptorSet* sets,
+        const uint32_t* dynamicOffset) const {
+        auto& boundSets = shadowState.bindPoints[bindPoint].descriptorSets;
+        if (boundSets.size() < firstSet + count) {
+            boundSets.resize(firstSet + count);
+        }
+        auto changed = false;
+        for (auto i = 0u; i < count; i++) {
+            const auto boundSet = BoundDescriptorSet {
+                .set = sets[i],
+                .dynamic = dynamicOffset != nullptr,
+                .offset = dynamicOffset != nullptr ? *dynamicOffset : 0,
+            };
+            if (boundSets[firstSet + i] != boundSet) {
+                boundSets[firstSet + i] = boundSet;
+                changed = true;
             }
         }
-        stagingBuffer->unmap();
+        if (!changed) {
+            skippedStateCount++;
+        }
+        return changed;
+    }
+
+    bool VKCommandList::updateVertexBuffers(
+        const uint32_t count,
+        const VkBuffer* buffers,
+        const VkDeviceSize* offsets) const {
+        // The bindings after the last one are left untouched by vkCmdBindVertexBuffers
+        if (shadowState.vertexBuffers.size() < count) {
+            shadowState.vertexBuffers.resize(count, VK_NULL_HANDLE);
+            shadowState.vertexOffsets.resize(count, 0);
+        }
+        if (std::equal(buffers, buffers + count, shadowState.vertexBuffers.begin()) &&
+            std::equal(offsets, offsets + count, shadowState.vertexOffsets.begin())) {
+            skippedStateCount++;
+            return false;
+        }
+        std::copy_n(buffers, count, shadowState.vertexBuffers.begin());
+        std::copy_n(offsets, count, shadowState.vertexOffsets.begin());
+        return true;
+    }
+
+    bool VKCommandList::updateViewports(const uint32_t count, const VkViewport* viewports) const {
+        if (shadowState.viewports.size() == count &&
+            std::memcmp(shadowState.viewports.data(), viewports, count * sizeof(VkViewport)) == 0) {
+            skippedStateCount++;
+            return false;
+        }
+        shadowState.viewports.assign(viewports, viewports + count);
+        return true;
+    }
+
+    bool VKCommandList::updateScissors(const uint32_t count, const VkRect2D* scissors) const {
+        if (shadowState.scissors.size() == count &&
+            std::memcmp(shadowState.scissors.data(), scissors, count * sizeof(VkRect2D)) == 0) {
+            skippedStateCount++;
+            return false;
+        }
+        shadowState.scissors.assign(scissors, scissors + count);
+        return true;
+    }
+
+    void VKCommandList::upload(const Buffer& destination, const void* source) {
+        assert(source != nullptr);
+        const auto& buffer = static_cast<const VKBuffer&>(destination);
+        const auto staging = allocateStaging(buffer.getSize(), L"StagingBuffer for buffer");
+        writeInstances(staging.mappedAddress, buffer, source);
 
         const auto copyRegion = VkBufferCopy{
-            .srcOffset = 0,
+            .srcOffset = staging.offset,
             .dstOffset = 0,
             .size = buffer.getSize(),
         };
+        flushBarriers();
         vkCmdCopyBuffer(
             commandBuffer,
-            stagingBuffer->getBuffer(),
+            staging.buffer,
             buffer.getBuffer(),
             1,
             &copyRegion);
+    }
 
-        stagingBuffers.push_back(stagingBuffer);
+    void VKCommandList::upload(
+        const Buffer& destination,
+        const void* source,
+        const size_t size,
+        const size_t offset) {
+        assert(source != nullptr);
+        assert(destination.getSize() >= (offset + size));
+        if (size == 0) { return; }
+        const auto& buffer = static_cast<const VKBuffer&>(destination);
+        const auto staging = allocateStaging(size, L"StagingBuffer for buffer range");
+        std::memcpy(staging.mappedAddress, source, size);
+
+        const auto copyRegion = VkBufferCopy{
+            .srcOffset = staging.offset,
+            .dstOffset = offset,
+            .size = size,
+        };
+        flushBarriers();
+        vkCmdCopyBuffer(
+            commandBuffer,
+            staging.buffer,
+            buffer.getBuffer(),
+            1,
+            &copyRegion);
+    }
+
+    void VKCommandList::upload(
+        const Buffer& destination,
+        const void* source,
+        const std::vector<BufferInstanceRange>& ranges) {
+        assert(source != nullptr);
+        const auto& buffer = static_cast<const VKBuffer&>(destination);
+        const auto mergedRanges = mergeInstanceRanges(ranges);
+        if (mergedRanges.empty()) { return; }
+        assert(mergedRanges.back().firstInstance + mergedRanges.back().instanceCount <= buffer.getInstanceCount());
+
+        // The instances are staged with the same alignment as in the destination buffer
+        VkDeviceSize stagingSize{0};
+        for (const auto& range : mergedRanges) {
+            stagingSize += VkDeviceSize{range.instanceCount} * buffer.getInstanceSizeAligned();
+        }
+        const auto staging = allocateStaging(stagingSize, L"StagingBuffer for buffer instances");
+
+        auto copyRegions = std::vector<VkBufferCopy>{};
+        copyRegions.reserve(mergedRanges.size());
+        VkDeviceSize stagingOffset{0};
+        for (const auto& range : mergedRanges) {
+            for (uint32_t i = 0; i < range.instanceCount; i++) {
+                std::memcpy(
+                    static_cast<std::byte*>(staging.mappedAddress) + stagingOffset +
+                        VkDeviceSize{i} * buffer.getInstanceSizeAligned(),
+                    static_cast<const std::byte*>(source) +
+                        VkDeviceSize{range.firstInstance + i} * buffer.getInstanceSize(),
+                    buffer.getInstanceSize());
+            }
+            copyRegions.push_back({
+                .srcOffset = staging.offset + stagingOffset,
+                .dstOffset = VkDeviceSize{range.firstInstance} * buffer.getInstanceSizeAligned(),
+                .size = VkDeviceSize{range.instanceCount - 1} * buffer.getInstanceSizeAligned() + buffer.getInstanceSize(),
+            });
+            stagingOffset += VkDeviceSize{range.instanceCount} * buffer.getInstanceSizeAligned();
+        }
+        flushBarriers();
+        vkCmdCopyBuffer(
+            commandBuffer,
+            staging.buffer,
+            buffer.getBuffer(),
+            static_cast<uint32_t>(copyRegions.size()),
+            copyRegions.data());
+    }
+
+    void VKCommandList::upload(const std::vector<BufferUploadInfo>& infos) {
+        // Each upload overwrites the whole buffer so only the last upload of a buffer is kept
+        auto uploads = std::vector<const BufferUploadInfo*>{};
+        auto destinations = std::set<const Buffer*>{};
+        for (auto it = infos.rbegin(); it != infos.rend(); ++it) {
+            assert(it->buffer != nullptr);
+            assert(it->data != nullptr);
+            if (destinations.insert(it->buffer.get()).second) {
+                uploads.push_back(&*it);
+            }
+        }
+        if (uploads.empty()) { return; }
+
+        // Pack all the sources in one staging range
+        const auto alignment = device->getStagingRing().getAlignment();
+        auto offsets = std::vector<VkDeviceSize>(uploads.size());
+        VkDeviceSize stagingSize{0};
+        for (int i = 0; i < uploads.size(); i++) {
+            offsets[i] = stagingSize;
+            stagingSize = (stagingSize + uploads[i]->buffer->getSize() + alignment - 1) & ~(alignment - 1);
+        }
+        const auto staging = allocateStaging(stagingSize, L"StagingBuffer for buffers");
+
+        flushBarriers();
+        for (int i = 0; i < uploads.size(); i++) {
+            const auto& buffer = static_cast<const VKBuffer&>(*uploads[i]->buffer);
+            writeInstances(static_cast<std::byte*>(staging.mappedAddress) + offsets[i], buffer, uploads[i]->data);
+            const auto copyRegion = VkBufferCopy{
+                .srcOffset = staging.offset + offsets[i],
+                .dstOffset = 0,
+                .size = buffer.getSize(),
+            };
+            vkCmdCopyBuffer(
+                commandBuffer,
+                staging.buffer,
+                buffer.getBuffer(),
+                1,
+                &copyRegion);
+        }
+    }
+
+    void VKCommandList::writeInstances(void* staging, const Buffer& buffer, const void* source) {
+        if ((buffer.getInstanceSizeAligned() == buffer.getInstanceSize()) || (buffer.getInstanceCount() == 1)) {
+            std::memcpy(staging, source, size_t{buffer.getInstanceSize()} * buffer.getInstanceCount());
+        } else {
+            for (uint32_t i = 0; i < buffer.getInstanceCount(); i++) {
+                std::memcpy(
+                    static_cast<std::byte*>(staging) + size_t{buffer.getInstanceSizeAligned()} * i,
+                    static_cast<const std::byte*>(source) + size_t{i} * buffer.getInstanceSize(),
+                    buffer.getInstanceSize());
+            }
+        }
     }
 
     void VKCommandList::copy(
         const Buffer& source,
         const Buffer& destination,
         const size_t size,
-        const uint32_t sourceOffset,
-        const uint32_t destinationOffset) const {
+        const size_t sourceOffset,
+        const size_t destinationOffset) const {
         const auto copySize = size == Buffer::WHOLE_SIZE ? min(source.getSize(), destination.getSize()) : size;
         assert(source.getSize() >= (copySize + sourceOffset));
         assert(destination.getSize() >= (copySize + destinationOffset));
@@ -1269,6 +1780,7 @@ namespace vireo {
             .dstOffset = destinationOffset,
             .size = copySize,
         };
+        flushBarriers();
         vkCmdCopyBuffer(
             commandBuffer,
             static_cast<const VKBuffer&>(source).getBuffer(),
@@ -1287,6 +1799,7 @@ namespace vireo {
             copyRegions[i].dstOffset = regions[i].dstOffset;
             copyRegions[i].size = regions[i].size;
         }
+        flushBarriers();
         vkCmdCopyBuffer(
             commandBuffer,
             static_cast<const VKBuffer&>(source).getBuffer(),
@@ -1302,28 +1815,15 @@ namespace vireo {
         assert(source != nullptr);
         assert(firstMipLevel < destination.getMipLevels());
         const auto& image = static_cast<const VKImage&>(destination);
-        const auto stagingBuffer = std::make_shared<VKBuffer>(
-           device,
-           BufferType::IMAGE_UPLOAD,
-           image.getImageSize(),
-           image.getArraySize(),
-           L"StagingBuffer for image");
-        stagingBuffer->map();
-        if (image.getArraySize() == 1) {
-            stagingBuffer->write(source);
-        } else {
-            for (int i = 0; i < image.getArraySize(); i++) {
-                stagingBuffer->write(
-                    static_cast<const unsigned char*>(source) + i * image.getImageSize(),
-                    image.getImageSize(),
-                    stagingBuffer->getInstanceSizeAligned() * i);
-            }
-        }
-        stagingBuffer->unmap();
+        const auto staging = allocateStaging(
+            image.getImageSize() * image.getArraySize(),
+            L"StagingBuffer for image",
+            Image::getPixelSize(image.getFormat()));
+        std::memcpy(staging.mappedAddress, source, staging.size);
 
         // https://vulkan-tutorial.com/Texture_mapping/Images#page_Copying-buffer-to-image
         const auto region = VkBufferImageCopy {
-            .bufferOffset = 0,
+            .bufferOffset = staging.offset,
             .bufferRowLength = 0,
             .bufferImageHeight = 0,
             .imageSubresource = {
@@ -1336,21 +1836,127 @@ namespace vireo {
             .imageExtent = {image.getWidth(), image.getHeight(), 1},
         };
 
+        flushBarriers();
         vkCmdCopyBufferToImage(
                 commandBuffer,
-                stagingBuffer->getBuffer(),
+                staging.buffer,
                 image.getImage(),
                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
                 1,
                 &region);
+    }
 
-        stagingBuffers.push_back(stagingBuffer);
+    void VKCommandList::upload(
+        const Image& destination,
+        const void* source,
+        const ImageRegion& region) {
+        assert(source != nullptr);
+        const auto size = VkDeviceSize{destination.getRowPitch(region)} * destination.getRowCount(region);
+        const auto staging = allocateStaging(
+            size,
+            L"StagingBuffer for image region",
+            Image::getPixelSize(destination.getFormat()));
+        std::memcpy(staging.mappedAddress, source, size);
+        copyToRegion(staging.buffer, staging.offset, 0, destination, region);
+    }
+
+    void VKCommandList::copyToRegion(
+        const VkBuffer buffer,
+        const VkDeviceSize offset,
+        const uint32_t rowLength,
+        const Image& destination,
+        const ImageRegion& region) const {
+        assert(region.mipLevel < destination.getMipLevels());
+        assert(region.arrayLayer < destination.getArraySize());
+        assert(region.width > 0 && region.height > 0);
+        assert(region.x + region.width <= std::max(1u, destination.getWidth() >> region.mipLevel));
+        assert(region.y + region.height <= std::max(1u, destination.getHeight() >> region.mipLevel));
+        const auto vkRegion = VkBufferImageCopy {
+            .bufferOffset = offset,
+            .bufferRowLength = rowLength,
+            .bufferImageHeight = 0,
+            .imageSubresource = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .mipLevel = region.mipLevel,
+                .baseArrayLayer = region.arrayLayer,
+                .layerCount = 1,
+            },
+            .imageOffset = {static_cast<int32_t>(region.x), static_cast<int32_t>(region.y), 0},
+            .imageExtent = {region.width, region.height, 1},
+        };
+        flushBarriers();
+        vkCmdCopyBufferToImage(
+                commandBuffer,
+                buffer,
+                static_cast<const VKImage&>(destination).getImage(),
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                1,
+                &vkRegion);
+    }
+
+    void VKCommandList::upload(const std::vector<ImageUploadInfo>& infos) {
+        // Each upload overwrites the whole image so only the last upload of an image is kept
+        auto uploads = std::vector<const ImageUploadInfo*>{};
+        auto destinations = std::set<const Image*>{};
+        for (auto it = infos.rbegin(); it != infos.rend(); ++it) {
+            assert(it->image != nullptr);
+            assert(it->data != nullptr);
+            if (destinations.insert(it->image.get()).second) {
+                uploads.push_back(&*it);
+            }
+        }
+        if (uploads.empty()) { return; }
+
+        // Pack all the sources in one staging range, aligned for the buffer to image copies :
+        // the offsets are multiple of the texel block sizes, 12 bytes for the RGB 32 bits formats
+        auto alignment = device->getStagingRing().getAlignment();
+        for (const auto* upload : uploads) {
+            alignment = std::lcm(alignment, VkDeviceSize{Image::getPixelSize(upload->image->getFormat())});
+        }
+        auto offsets = std::vector<VkDeviceSize>(uploads.size());
+        VkDeviceSize stagingSize{0};
+        for (int i = 0; i < uploads.size(); i++) {
+            const auto& image = *uploads[i]->image;
+            offsets[i] = stagingSize;
+            stagingSize = (stagingSize + image.getImageSize() * image.getArraySize() + alignment - 1) /
+                alignment * alignment;
+        }
+        const auto staging = allocateStaging(stagingSize, L"StagingBuffer for images", alignment);
+
+        flushBarriers();
+        for (int i = 0; i < uploads.size(); i++) {
+            const auto& image = static_cast<const VKImage&>(*uploads[i]->image);
+            std::memcpy(
+                static_cast<std::byte*>(staging.mappedAddress) + offsets[i],
+                uploads[i]->data,
+                image.getImageSize() * image.getArraySize());
+            const auto region = VkBufferImageCopy {
+                .bufferOffset = staging.offset + offsets[i],
+                .bufferRowLength = 0,
+                .bufferImageHeight = 0,
+                .imageSubresource = {
+                    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                    .mipLevel = 0,
+                    .baseArrayLayer = 0,
+                    .layerCount = image.getArraySize(),
+                },
+                .imageOffset = {0, 0, 0},
+                .imageExtent = {image.getWidth(), image.getHeight(), 1},
+            };
+            vkCmdCopyBufferToImage(
+                    commandBuffer,
+                    staging.buffer,
+                    image.getImage(),
+                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    1,
+                    &region);
+        }
     }
 
     void VKCommandList::copy(
         const Buffer& source,
         const Image& destination,
-        const uint32_t sourceOffset,
+        const size_t sourceOffset,
         const uint32_t mipLevel,
         const bool rowPitchAlignment) const {
         assert(mipLevel < destination.getMipLevels());
@@ -1369,6 +1975,7 @@ namespace vireo {
             .imageOffset = {0, 0, 0},
             .imageExtent = {image.getWidth() >> mipLevel, image.getHeight() >> mipLevel, 1},
         };
+        flushBarriers();
         vkCmdCopyBufferToImage(
                 commandBuffer,
                 buffer.getBuffer(),
@@ -1404,6 +2011,7 @@ namespace vireo {
             };
             copyRegions.emplace_back(buffer_copy_region);
         }
+        flushBarriers();
         vkCmdCopyBufferToImage(
                        commandBuffer,
                        buffer.getBuffer(),
@@ -1413,10 +2021,27 @@ namespace vireo {
                        copyRegions.data());
     }
 
+    void VKCommandList::copy(
+        const Buffer& source,
+        const Image& destination,
+        const ImageRegion& region,
+        const size_t sourceOffset) const {
+        // bufferRowLength is in texels, the compressed formats rows are rows of 4x4 blocks
+        const auto blockWidth = destination.getFormat() >= ImageFormat::BC1_UNORM ? 4 : 1;
+        const auto rowLength = destination.getAlignedRowPitch(region) /
+            Image::getPixelSize(destination.getFormat()) * blockWidth;
+        copyToRegion(
+            static_cast<const VKBuffer&>(source).getBuffer(),
+            sourceOffset,
+            rowLength,
+            destination,
+            region);
+    }
+
     void VKCommandList::copy(
         const Image& source,
         const Buffer& destination,
-        const uint32_t destinationOffset,
+        const size_t destinationOffset,
         const uint32_t firstMipLevel) const {
         assert(firstMipLevel < source.getMipLevels());
         const auto& image = static_cast<const VKImage&>(source);
@@ -1434,6 +2059,7 @@ namespace vireo {
             .imageOffset = {0, 0, 0},
             .imageExtent = {image.getWidth() >> firstMipLevel, image.getHeight() >> firstMipLevel, 1},
         };
+        flushBarriers();
         vkCmdCopyImageToBuffer(
                 commandBuffer,
                 image.getImage(),
@@ -1450,23 +2076,19 @@ namespace vireo {
         assert(sources.size() == destination.getArraySize());
         assert(firstMipLevel < destination.getMipLevels());
         const auto& image = static_cast<const VKImage&>(destination);
-        const auto stagingBuffer = std::make_shared<VKBuffer>(
-           device,
-           BufferType::IMAGE_UPLOAD,
-           image.getImageSize(),
-           image.getArraySize(),
-           L"StagingBuffer for image array");
-        stagingBuffer->map();
+        const auto staging = allocateStaging(
+            image.getImageSize() * image.getArraySize(),
+            L"StagingBuffer for image array",
+            Image::getPixelSize(image.getFormat()));
         for (int i = 0; i < image.getArraySize(); i++) {
-            stagingBuffer->write(
+            std::memcpy(
+                static_cast<std::byte*>(staging.mappedAddress) + image.getImageSize() * i,
                 sources[i],
-                image.getImageSize(),
-                stagingBuffer->getInstanceSizeAligned() * i);
+                image.getImageSize());
         }
-        stagingBuffer->unmap();
 
         const auto region = VkBufferImageCopy {
-            .bufferOffset = 0,
+            .bufferOffset = staging.offset,
             .bufferRowLength = 0,
             .bufferImageHeight = 0,
             .imageSubresource = {
@@ -1478,14 +2100,14 @@ namespace vireo {
             .imageOffset = {0, 0, 0},
             .imageExtent = {image.getWidth() >> firstMipLevel, image.getHeight() >> firstMipLevel, 1},
         };
+        flushBarriers();
         vkCmdCopyBufferToImage(
                 commandBuffer,
-                stagingBuffer->getBuffer(),
+                staging.buffer,
                 image.getImage(),
                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
                 1,
                 &region);
-        stagingBuffers.push_back(stagingBuffer);
     }
 
     void VKCommandList::copy(
@@ -1506,6 +2128,7 @@ namespace vireo {
         copyRegion.dstOffset = {0, 0, 0};
         copyRegion.extent = {source.getWidth(), source.getHeight(), 1};
 
+        flushBarriers();
         vkCmdCopyImage(commandBuffer,
                        vkSource.getImage(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
                        vkSwapChain.getCurrentImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
@@ -1558,6 +2181,24 @@ namespace vireo {
 #endif
     }
 
+    uint64_t VKSemaphore::getCompletedValue() const {
+        assert(type == SemaphoreType::TIMELINE);
+        auto completedValue = uint64_t{0};
+        vkCheck(vkGetSemaphoreCounterValue(device, semaphore, &completedValue));
+        return completedValue;
+    }
+
+    void VKSemaphore::wait(const uint64_t value) const {
+        assert(type == SemaphoreType::TIMELINE);
+        const auto waitInfo = VkSemaphoreWaitInfo {
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+            .semaphoreCount = 1,
+            .pSemaphores = &semaphore,
+            .pValues = &value,
+        };
+        vkCheck(vkWaitSemaphores(device, &waitInfo, UINT64_MAX));
+    }
+
     VKSemaphore::~VKSemaphore() {
         vkDestroySemaphore(device, semaphore, nullptr);
     }
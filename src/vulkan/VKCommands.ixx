@@ -13,6 +13,7 @@ import vireo;
 
 import vireo.vulkan.devices;
 import vireo.vulkan.descriptors;
+import vireo.vulkan.memory;
 import vireo.vulkan.resources;
 
 export namespace vireo {
@@ -59,6 +60,10 @@ export namespace vireo {
 
         auto getSemaphore() const { return semaphore; }
 
+        uint64_t getCompletedValue() const override;
+
+        void wait(uint64_t value) const override;
+
         ~VKSemaphore() override;
 
     private:
@@ -70,6 +75,8 @@ export namespace vireo {
     public:
         VKSubmitQueue(const std::shared_ptr<const VKDevice>& device, CommandType type, const std::wstring& name);
 
+        ~VKSubmitQueue() override;
+
         auto getCommandQueue() const { return commandQueue; }
 
         void submit(
@@ -114,8 +121,17 @@ export namespace vireo {
         void waitIdle() const override;
 
     private:
-        VkQueue commandQueue;
-
+        const std::shared_ptr<const VKDevice> device;
+        VkQueue                               commandQueue;
+        // Timeline semaphore signaled by each submission, retires the staging ranges of the command lists
+        VkSemaphore                           retireSemaphore;
+        mutable uint64_t                      submittedValue{0};
+
+        // Submits with the retire semaphore and retires the staging ranges of the command lists
+        void queueSubmit(
+            VkSubmitInfo2 submitInfo,
+            VkFence fence,
+            const std::vector<std::shared_ptr<const CommandList>>& commandLists) const;
     };
 
     class VKCommandAllocator : public CommandAllocator {
@@ -130,6 +146,8 @@ export namespace vireo {
 
         std::shared_ptr<CommandList> createCommandList() const override;
 
+        std::shared_ptr<CommandList> createSecondaryCommandList() const override;
+
     private:
         const std::shared_ptr<const VKDevice> device;
         VkCommandPool                    commandPool;
@@ -141,12 +159,21 @@ export namespace vireo {
             VK_INDEX_TYPE_UINT16,
             VK_INDEX_TYPE_UINT32,
         };
+        static constexpr VkCommandBufferUsageFlags vkUsages[] {
+            0,
+            VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+            VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT,
+        };
 
-        VKCommandList(const std::shared_ptr<const VKDevice>& device, VkCommandPool commandPool);
+        VKCommandList(const std::shared_ptr<const VKDevice>& device, VkCommandPool commandPool, bool secondary);
 
         ~VKCommandList() override;
 
-        void begin() const override;
+        void begin(CommandListUsage usage = CommandListUsage::DEFAULT) const override;
+
+        void begin(
+            const RenderingConfiguration& conf,
+            CommandListUsage usage = CommandListUsage::DEFAULT) const override;
 
         void end() const override;
 
@@ -156,15 +183,35 @@ export namespace vireo {
             const Buffer& destination,
             const void* source) override;
 
+        void upload(
+            const Buffer& destination,
+            const void* source,
+            size_t size,
+            size_t offset) override;
+
+        void upload(
+            const Buffer& destination,
+            const void* source,
+            const std::vector<BufferInstanceRange>& ranges) override;
+
+        void upload(const std::vector<BufferUploadInfo>& infos) override;
+
         void upload(
             const Image& destination,
             const void* source,
             uint32_t firstMipLevel) override;
 
+        void upload(const std::vector<ImageUploadInfo>& infos) override;
+
+        void upload(
+            const Image& destination,
+            const void* source,
+            const ImageRegion& region) override;
+
         void copy(
             const Buffer& source,
             const Image& destination,
-            uint32_t sourceOffset,
+            size_t sourceOffset,
             uint32_t mipLevel,
             bool rowPitchAlignment) const override;
 
@@ -174,18 +221,24 @@ export namespace vireo {
             const std::vector<size_t>& sourceOffsets,
             bool rowPitchAlignment) const override;
 
+        void copy(
+            const Buffer& source,
+            const Image& destination,
+            const ImageRegion& region,
+            size_t sourceOffset) const override;
+
         void copy(
             const Image& source,
             const Buffer& destination,
-            uint32_t destinationOffset,
+            size_t destinationOffset,
             uint32_t firstMipLevel) const override;
 
         void copy(
             const Buffer& source,
             const Buffer& destination,
             size_t size,
-            uint32_t sourceOffset,
-            uint32_t destinationOffset) const override;
+            size_t sourceOffset,
+            size_t destinationOffset) const override;
 
         void copy(
             const Buffer& source,
@@ -205,6 +258,8 @@ export namespace vireo {
 
         void endRendering() override;
 
+        void executeCommands(const std::vector<std::shared_ptr<const CommandList>>& commandLists) override;
+
         void dispatch(uint32_t x, uint32_t y, uint32_t z) const override;
 
         void bindVertexBuffers(
@@ -303,27 +358,129 @@ export namespace vireo {
             ResourceState oldState,
             ResourceState newState) const override;
 
+        void barrier(
+            const std::shared_ptr<const Image>& before,
+            const std::shared_ptr<const Image>& after) const override;
+
+        void barrier(
+            const Buffer& before,
+            const Buffer& after) const override;
+
+        void transferOwnership(
+            const Buffer& buffer,
+            CommandType source,
+            CommandType destination,
+            size_t offset,
+            size_t size) const override;
+
+        void transferOwnership(
+            const Image& image,
+            CommandType source,
+            CommandType destination,
+            uint32_t mipLevel,
+            uint32_t arrayLayer) const override;
+
         void pushConstants(
             const std::shared_ptr<const PipelineResources>& pipelineResources,
             const PushConstantsDesc& pushConstants,
             const void* data) const override;
 
+        uint32_t getSkippedStateCount() const override { return skippedStateCount; }
+
         auto getCommandBuffer() const { return commandBuffer; }
 
+        // Adds a submission to the staging ring ranges, they are kept until the next recording
+        void retireStaging(VkSemaphore semaphore, uint64_t value) const;
+
     private:
+        struct BoundDescriptorSet {
+            VkDescriptorSet set{VK_NULL_HANDLE};
+            bool            dynamic{false};
+            uint32_t        offset{0};
+
+            bool operator==(const BoundDescriptorSet&) const = default;
+        };
+
+        // Pipeline & descriptor sets bound to a pipeline bind point
+        struct BindPointState {
+            VkPipeline                      pipeline{VK_NULL_HANDLE};
+            VkPipelineLayout                layout{VK_NULL_HANDLE};
+            // Indexed by set number, VK_NULL_HANDLE for the unknown sets
+            std::vector<BoundDescriptorSet> descriptorSets;
+        };
+
+        // Shadow copy of the state recorded since begin(), used to skip the redundant binds & dynamic state
+        struct ShadowState {
+            // Indexed by VK_PIPELINE_BIND_POINT_GRAPHICS & VK_PIPELINE_BIND_POINT_COMPUTE
+            BindPointState            bindPoints[2];
+            std::vector<VkBuffer>     vertexBuffers;
+            std::vector<VkDeviceSize> vertexOffsets;
+            VkBuffer                  indexBuffer{VK_NULL_HANDLE};
+            VkDeviceSize              indexOffset{0};
+            VkIndexType               indexType{VK_INDEX_TYPE_UINT16};
+            std::vector<VkViewport>   viewports;
+            std::vector<VkRect2D>     scissors;
+            std::optional<uint32_t>   stencilReference;
+        };
+
         const std::shared_ptr<const VKDevice>   device;
+        const bool                              secondary;
         VkCommandBuffer                         commandBuffer;
-        // Staging buffers used by the upload() methods
+        // Staging buffers used by the upload() methods when the staging ring is full
         std::vector<std::shared_ptr<VKBuffer>>  stagingBuffers{};
+        // Staging ring ranges used by the upload() methods, retired by each submission and released on begin()
+        // & cleanup() : the ring recycles them once the last submission of the recording is finished
+        mutable std::vector<VKStagingAllocation> stagingAllocations{};
+        mutable ShadowState                     shadowState{};
+        mutable uint32_t                        skippedStateCount{0};
+        // Barriers recorded since the last command using the resources, flushed in one vkCmdPipelineBarrier2
+        mutable std::vector<VkImageMemoryBarrier2>  pendingImageBarriers{};
+        mutable std::vector<VkBufferMemoryBarrier2> pendingBufferBarriers{};
+
+        // Returns a mapped staging range, from the device staging ring if possible.
+        // The buffer to image copies need an offset aligned on the texel block size of the image
+        VKStagingAllocation allocateStaging(VkDeviceSize size, const std::wstring& name, VkDeviceSize alignment = 1);
+
+        void releaseStaging() const;
+
+        // Resets the command buffer & the shadow state and starts the recording
+        void beginCommandBuffer(const VkCommandBufferBeginInfo& beginInfo) const;
+
+        // The update*() functions record the state in the shadow state and return false,
+        // counting a skipped command, if the state is already set
+
+        bool updateDescriptorSets(
+            VkPipelineBindPoint bindPoint,
+            uint32_t firstSet,
+            uint32_t count,
+            const VkDescriptorSet* sets,
+            const uint32_t* dynamicOffset) const;
+
+        bool updateVertexBuffers(uint32_t count, const VkBuffer* buffers, const VkDeviceSize* offsets) const;
+
+        bool updateViewports(uint32_t count, const VkViewport* viewports) const;
+
+        bool updateScissors(uint32_t count, const VkRect2D* scissors) const;
+
+        // Copy the buffer instances into staging memory with the destination buffer alignment
+        static void writeInstances(void* staging, const Buffer& buffer, const void* source);
+
+        // Records the copy of buffer rows into a region of an image, `rowLength` in texels or 0 for packed rows
+        void copyToRegion(
+            VkBuffer buffer,
+            VkDeviceSize offset,
+            uint32_t rowLength,
+            const Image& destination,
+            const ImageRegion& region) const;
 
         // Convert Vireo states to Vulkan state while trying to match pipeline stages
         static void convertState(
             ResourceState oldState,
             ResourceState newState,
-            VkPipelineStageFlags& srcStage,
-            VkPipelineStageFlags& dstStage,
-            VkAccessFlags& srcAccess,
-            VkAccessFlags& dstAccess,
+            VkPipelineStageFlags2& srcStage,
+            VkPipelineStageFlags2& dstStage,
+            VkAccessFlags2& srcAccess,
+            VkAccessFlags2& dstAccess,
             VkImageLayout& srcLayout,
             VkImageLayout& dstLayout,
             VkImageAspectFlagBits& aspectFlag);
@@ -331,10 +488,21 @@ export namespace vireo {
         static void convertState(
             ResourceState oldState,
             ResourceState newState,
-            VkPipelineStageFlags& srcStage,
-            VkPipelineStageFlags& dstStage,
-            VkAccessFlags& srcAccess,
-            VkAccessFlags& dstAccess);
+            VkPipelineStageFlags2& srcStage,
+            VkPipelineStageFlags2& dstStage,
+            VkAccessFlags2& srcAccess,
+            VkAccessFlags2& dstAccess);
+
+        // Makes all the writes to an aliased memory range available before reusing the memory
+        void aliasingBarrier() const;
+
+        // Adds a barrier to the pending barriers, flushing them first if they already transition the same resource
+        void addBarrier(const VkImageMemoryBarrier2& barrier) const;
+
+        void addBarrier(const VkBufferMemoryBarrier2& barrier) const;
+
+        // Records the pending barriers, must be called before recording a command using the resources
+        void flushBarriers() const;
 
         void barrier(const std::vector<VkImage>& images,
            ResourceState oldState,
@@ -169,6 +169,33 @@ namespace vireo {
             // Get the GPU description and total memory
             // getAdapterDescFromOS();
             vkGetPhysicalDeviceFeatures(physicalDevice, &deviceFeatures);
+            // Optional device extensions, enabled when supported
+            for (const auto* extension : {
+                // Per-heap usage & budget
+                VK_EXT_MEMORY_BUDGET_EXTENSION_NAME,
+                // Buffers using existing host memory
+                VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME,
+            }) {
+                if (checkDeviceExtensionSupport(physicalDevice, { extension })) {
+                    deviceExtensions.push_back(extension);
+                }
+            }
+            if (isDeviceExtensionEnabled(VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME)) {
+                auto externalMemoryHostProperties = VkPhysicalDeviceExternalMemoryHostPropertiesEXT {
+                    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_MEMORY_HOST_PROPERTIES_EXT,
+                };
+                auto properties = VkPhysicalDeviceProperties2 {
+                    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+                    .pNext = &externalMemoryHostProperties,
+                };
+                vkGetPhysicalDeviceProperties2(physicalDevice, &properties);
+                minImportedHostPointerAlignment = externalMemoryHostProperties.minImportedHostPointerAlignment;
+            }
+            // Host to image copies without staging buffer
+            if (checkDeviceExtensionSupport(physicalDevice, { VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME }) &&
+                isHostImageCopyUsable()) {
+                deviceExtensions.push_back(VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME);
+            }
         } else {
             throw Exception("Failed to find a suitable GPU!");
         }
@@ -299,6 +326,51 @@ namespace vireo {
         return score;
     }
 
+    bool VKPhysicalDevice::isHostImageCopyUsable() const {
+        auto hostImageCopyFeatures = VkPhysicalDeviceHostImageCopyFeaturesEXT {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_FEATURES_EXT,
+        };
+        auto features = VkPhysicalDeviceFeatures2 {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+            .pNext = &hostImageCopyFeatures,
+        };
+        vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+        if (!hostImageCopyFeatures.hostImageCopy) {
+            return false;
+        }
+        // The copies must leave the images ready to be sampled, like the uploads recorded in command lists
+        auto hostImageCopyProperties = VkPhysicalDeviceHostImageCopyPropertiesEXT {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_PROPERTIES_EXT,
+        };
+        auto properties = VkPhysicalDeviceProperties2 {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+            .pNext = &hostImageCopyProperties,
+        };
+        vkGetPhysicalDeviceProperties2(physicalDevice, &properties);
+        auto copyDstLayouts = std::vector<VkImageLayout>(hostImageCopyProperties.copyDstLayoutCount);
+        hostImageCopyProperties.pCopyDstLayouts = copyDstLayouts.data();
+        vkGetPhysicalDeviceProperties2(physicalDevice, &properties);
+        return std::ranges::find(copyDstLayouts, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) != copyDstLayouts.end();
+    }
+
+    bool VKPhysicalDevice::isHostImageCopyFormatSupported(const VkFormat format) const {
+        auto formatProperties3 = VkFormatProperties3 {
+            .sType = VK_STRUCTURE_TYPE_FORMAT_PROPERTIES_3,
+        };
+        auto formatProperties = VkFormatProperties2 {
+            .sType = VK_STRUCTURE_TYPE_FORMAT_PROPERTIES_2,
+            .pNext = &formatProperties3,
+        };
+        vkGetPhysicalDeviceFormatProperties2(physicalDevice, format, &formatProperties);
+        return (formatProperties3.optimalTilingFeatures & VK_FORMAT_FEATURE_2_HOST_IMAGE_TRANSFER_BIT_EXT) != 0;
+    }
+
+    bool VKPhysicalDevice::isDeviceExtensionEnabled(const char* extensionName) const {
+        return std::ranges::any_of(deviceExtensions, [&](const char* extension) {
+            return std::string_view{extension} == extensionName;
+        });
+    }
+
     bool VKPhysicalDevice::checkDeviceExtensionSupport(
         const VkPhysicalDevice            vkPhysicalDevice,
         const std::vector<const char *> &deviceExtensions) {
@@ -381,9 +453,14 @@ namespace vireo {
 
         // Initialize device extensions and create a logical device
         {
+            VkPhysicalDeviceHostImageCopyFeaturesEXT hostImageCopyFeatures{
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_FEATURES_EXT,
+                .pNext = nullptr,
+                .hostImageCopy = VK_TRUE,
+            };
             VkPhysicalDeviceSynchronization2FeaturesKHR sync2Features{
                 .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES,
-                .pNext = nullptr,
+                .pNext = physicalDevice.isHostImageCopySupported() ? &hostImageCopyFeatures : nullptr,
                 .synchronization2 = VK_TRUE
             };
             VkPhysicalDeviceFeatures2 deviceFeatures2 {
@@ -431,6 +508,17 @@ namespace vireo {
 #endif
             vulkanInitializeDevice(device);
         }
+
+        memoryAllocator = std::make_unique<VKMemoryAllocator>(
+            physicalDevice.getPhysicalDevice(),
+            device,
+            physicalDevice.isDeviceExtensionEnabled(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME));
+        stagingRing = std::make_unique<VKStagingRing>(
+            device,
+            *memoryAllocator,
+            VKStagingRing::DEFAULT_SIZE,
+            std::max(VkDeviceSize{16}, physicalDevice.getDeviceProperties().limits.optimalBufferCopyOffsetAlignment));
+        deletionQueue = std::make_unique<VKDeletionQueue>();
     }
 
     VkImageView VKDevice::createImageView(const VkImage            image,
@@ -463,6 +551,11 @@ namespace vireo {
     }
 
     VKDevice::~VKDevice() {
+        // Destroys the objects still queued when the application never called collect() or waitIdle()
+        vkDeviceWaitIdle(device);
+        deletionQueue->flush();
+        stagingRing.reset();
+        memoryAllocator.reset();
         vkDestroyDevice(device, nullptr);
     }
 
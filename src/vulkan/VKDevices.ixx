@@ -10,6 +10,7 @@ export module vireo.vulkan.devices;
 
 import std;
 import vireo;
+import vireo.vulkan.memory;
 
 export namespace vireo {
 
@@ -53,6 +54,18 @@ export namespace vireo {
 
         const auto& getDeviceExtensions() const { return deviceExtensions; }
 
+        // Returns true if a mandatory or a supported optional extension is enabled
+        bool isDeviceExtensionEnabled(const char* extensionName) const;
+
+        // Returns true if VK_EXT_host_image_copy is enabled
+        bool isHostImageCopySupported() const { return isDeviceExtensionEnabled(VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME); }
+
+        // Alignment of the host memory imported with VK_EXT_external_memory_host, 0 if the extension is not enabled
+        auto getMinImportedHostPointerAlignment() const { return minImportedHostPointerAlignment; }
+
+        // Returns true if the images of a format can be the destination of host copies
+        bool isHostImageCopyFormatSupported(VkFormat format) const;
+
         const auto& getDeviceProperties() const { return deviceProperties.properties; }
 
         struct QueueFamilyIndices {
@@ -96,6 +109,7 @@ export namespace vireo {
             VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES
         };
         VkSampleCountFlagBits        sampleCount;
+        VkDeviceSize                 minImportedHostPointerAlignment{0};
 
         struct SwapChainSupportDetails {
             VkSurfaceCapabilitiesKHR   capabilities;
@@ -113,6 +127,9 @@ export namespace vireo {
             const std::vector<const char *> &deviceExtensions);
 
         VkSampleCountFlagBits getMaxUsableMSAASampleCount() const;
+
+        // Returns true if the device supports the host image copies feature with the layouts we need
+        bool isHostImageCopyUsable() const;
     };
 
     class VKDevice : public Device {
@@ -130,6 +147,14 @@ export namespace vireo {
 
         auto getTransferQueueFamilyIndex() const { return transferQueueFamilyIndex; }
 
+        // Queue family of the submit queues and command allocators of a command type
+        auto getQueueFamilyIndex(const CommandType type) const {
+            return
+                type == CommandType::COMPUTE ? computeQueueFamilyIndex :
+                type == CommandType::TRANSFER ? transferQueueFamilyIndex :
+                graphicsQueueFamilyIndex;
+        }
+
         VkImageView createImageView(VkImage            image,
                                     VkFormat           format,
                                     VkImageAspectFlags aspectFlags,
@@ -139,9 +164,21 @@ export namespace vireo {
                                     uint32_t           layers = 1,
                                     uint32_t           baseMipLevel = 0) const;
 
+        auto& getMemoryAllocator() const { return *memoryAllocator; }
+
+        auto& getStagingRing() const { return *stagingRing; }
+
+        auto& getDeletionQueue() const { return *deletionQueue; }
+
     private:
         const VKPhysicalDevice& physicalDevice;
         VkDevice    device{VK_NULL_HANDLE};
+        // Sub-allocator used by the buffers & images
+        std::unique_ptr<VKMemoryAllocator> memoryAllocator;
+        // Staging memory used by the command lists uploads
+        std::unique_ptr<VKStagingRing>     stagingRing;
+        // Deferred destruction of the buffers, images & heaps
+        std::unique_ptr<VKDeletionQueue>   deletionQueue;
         uint32_t    graphicsQueueFamilyIndex;
         uint32_t    transferQueueFamilyIndex;
         uint32_t    computeQueueFamilyIndex;
@@ -0,0 +1,459 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+module;
+#include "vireo/backend/vulkan/Libraries.h"
+#include <cassert>
+module vireo.vulkan.memory;
+
+import vireo.tools;
+
+import vireo.vulkan.tools;
+
+namespace vireo {
+
+    VKMemoryAllocator::VKMemoryAllocator(
+        const VkPhysicalDevice physicalDevice,
+        const VkDevice device,
+        const bool budgetSupported) :
+        physicalDevice{physicalDevice},
+        device{device},
+        budgetSupported{budgetSupported} {
+        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+        nonCoherentAtomSize = properties.limits.nonCoherentAtomSize;
+        blocks.resize(memoryProperties.memoryTypeCount);
+    }
+
+    VKMemoryAllocator::~VKMemoryAllocator() {
+        for (const auto& memoryTypeBlocks : blocks) {
+            for (const auto& block : memoryTypeBlocks) {
+                destroyBlock(*block);
+            }
+        }
+    }
+
+    uint32_t VKMemoryAllocator::findMemoryType(const uint32_t typeFilter, const VkMemoryPropertyFlags properties) const {
+        for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+            if ((typeFilter & (1 << i)) &&
+                (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) { return i; }
+        }
+        throw Exception("failed to find suitable memory type!");
+    }
+
+    bool VKMemoryAllocator::isMemoryTypeAvailable(
+        const uint32_t typeFilter,
+        const VkMemoryPropertyFlags properties) const {
+        for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+            if ((typeFilter & (1 << i)) &&
+                (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) { return true; }
+        }
+        return false;
+    }
+
+    bool VKMemoryAllocator::isWithinBudget(const uint32_t memoryTypeIndex, const VkDeviceSize size) const {
+        const auto heapIndex = memoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+        auto usage = getHeapAllocatedBytes(heapIndex);
+        auto budget = memoryProperties.memoryHeaps[heapIndex].size;
+        if (budgetSupported) {
+            // The budget changes with the other processes, it can't be cached
+            auto budgetProperties = VkPhysicalDeviceMemoryBudgetPropertiesEXT {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT,
+            };
+            auto memoryProperties2 = VkPhysicalDeviceMemoryProperties2 {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2,
+                .pNext = &budgetProperties,
+            };
+            vkGetPhysicalDeviceMemoryProperties2(physicalDevice, &memoryProperties2);
+            usage = budgetProperties.heapUsage[heapIndex];
+            budget = budgetProperties.heapBudget[heapIndex];
+        }
+        return usage + size <= budget;
+    }
+
+    VkMemoryPropertyFlags VKMemoryAllocator::getHostWriteProperties(
+        const uint32_t typeFilter,
+        const VkDeviceSize size) const {
+        constexpr auto hostVisible = VkMemoryPropertyFlags{
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT};
+        // Resizable BAR and UMA devices expose device local memory types mappable by the CPU.
+        // Without resizable BAR the heap is only 256MB, keep it for the buffers fitting in the budget
+        constexpr auto writableDeviceLocal = hostVisible | VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        return isMemoryTypeAvailable(typeFilter, writableDeviceLocal) &&
+            isWithinBudget(findMemoryType(typeFilter, writableDeviceLocal), size) ?
+            writableDeviceLocal :
+            hostVisible;
+    }
+
+    VkDeviceSize VKMemoryAllocator::getBlockSize(const uint32_t memoryTypeIndex) const {
+        constexpr VkDeviceSize smallHeapSize{1024ull * 1024 * 1024};
+        const auto heapSize = memoryProperties.memoryHeaps[memoryProperties.memoryTypes[memoryTypeIndex].heapIndex].size;
+        return heapSize <= smallHeapSize ? heapSize / 8 : DEFAULT_BLOCK_SIZE;
+    }
+
+    VKMemoryAllocation VKMemoryAllocator::allocate(
+        const VkMemoryRequirements& requirements,
+        const VkMemoryPropertyFlags properties,
+        const bool linear,
+        const bool dedicated) {
+        const auto memoryTypeIndex = findMemoryType(requirements.memoryTypeBits, properties);
+        const auto blockSize = getBlockSize(memoryTypeIndex);
+        // Non-coherent memory is flushed and invalidated by atoms, two resources never share an atom
+        auto size = requirements.size;
+        auto alignment = requirements.alignment;
+        const auto typeProperties = memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags;
+        if ((typeProperties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) &&
+            !(typeProperties & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
+            alignment = std::max(alignment, nonCoherentAtomSize);
+            size = (size + nonCoherentAtomSize - 1) & ~(nonCoherentAtomSize - 1);
+        }
+        auto lock = std::lock_guard(mutex);
+
+        VKMemoryBlock* block{nullptr};
+        std::optional<VkDeviceSize> offset;
+        if (dedicated || size > blockSize / 2 || (properties & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT)) {
+            // Large resources get their own memory to avoid wasting a block,
+            // lazily allocated memory is only committed if used so it is never shared
+            block = createBlock(memoryTypeIndex, size, linear, true);
+            offset = allocateRange(*block, size, alignment);
+        } else {
+            for (const auto& candidate : blocks[memoryTypeIndex]) {
+                if (candidate->dedicated || candidate->linear != linear) { continue; }
+                offset = allocateRange(*candidate, size, alignment);
+                if (offset.has_value()) {
+                    block = candidate.get();
+                    break;
+                }
+            }
+            if (!block) {
+                block = createBlock(memoryTypeIndex, blockSize, linear, false);
+                offset = allocateRange(*block, size, alignment);
+            }
+        }
+        assert(offset.has_value());
+        block->allocationCount += 1;
+        return {
+            .memory = block->memory,
+            .offset = *offset,
+            .size = size,
+            .mappedAddress = block->mappedAddress ? static_cast<std::byte*>(block->mappedAddress) + *offset : nullptr,
+            .block = block,
+        };
+    }
+
+    void VKMemoryAllocator::free(const VKMemoryAllocation& allocation) {
+        assert(allocation.block != nullptr);
+        auto lock = std::lock_guard(mutex);
+        auto& block = *allocation.block;
+
+        // Returns the range to the free list and merge it with its free neighbors
+        auto offset = allocation.offset;
+        auto size = allocation.size;
+        const auto next = block.freeRanges.find(offset + size);
+        if (next != block.freeRanges.end()) {
+            size += next->second;
+            block.freeRanges.erase(next);
+        }
+        auto it = block.freeRanges.lower_bound(offset);
+        if (it != block.freeRanges.begin()) {
+            const auto previous = std::prev(it);
+            if (previous->first + previous->second == offset) {
+                offset = previous->first;
+                size += previous->second;
+                block.freeRanges.erase(previous);
+            }
+        }
+        block.freeRanges[offset] = size;
+        block.allocationCount -= 1;
+
+        if (block.allocationCount == 0) {
+            // Keep one empty block per memory type to avoid allocate/free cycles
+            auto& memoryTypeBlocks = blocks[block.memoryTypeIndex];
+            const auto emptyBlocks = std::ranges::count_if(memoryTypeBlocks, [&](const auto& other) {
+                return !other->dedicated && other->linear == block.linear && other->allocationCount == 0;
+            });
+            if (block.dedicated || emptyBlocks > 1) {
+                destroyBlock(block);
+                std::erase_if(memoryTypeBlocks, [&](const auto& other) { return other.get() == &block; });
+            }
+        }
+    }
+
+    std::optional<VkDeviceSize> VKMemoryAllocator::allocateRange(
+        VKMemoryBlock& block,
+        const VkDeviceSize size,
+        const VkDeviceSize alignment) {
+        auto bestFit = block.freeRanges.end();
+        VkDeviceSize bestFitOffset{0};
+        for (auto it = block.freeRanges.begin(); it != block.freeRanges.end(); ++it) {
+            const auto alignedOffset = (it->first + alignment - 1) & ~(alignment - 1);
+            const auto padding = alignedOffset - it->first;
+            if (it->second >= padding + size &&
+                (bestFit == block.freeRanges.end() || it->second < bestFit->second)) {
+                bestFit = it;
+                bestFitOffset = alignedOffset;
+                if (it->second == padding + size) { break; }
+            }
+        }
+        if (bestFit == block.freeRanges.end()) {
+            return {};
+        }
+
+        // Split the free range, the alignment padding stay in the free list
+        const auto rangeOffset = bestFit->first;
+        const auto rangeSize = bestFit->second;
+        block.freeRanges.erase(bestFit);
+        if (bestFitOffset > rangeOffset) {
+            block.freeRanges[rangeOffset] = bestFitOffset - rangeOffset;
+        }
+        const auto rangeEnd = rangeOffset + rangeSize;
+        if (bestFitOffset + size < rangeEnd) {
+            block.freeRanges[bestFitOffset + size] = rangeEnd - (bestFitOffset + size);
+        }
+        return bestFitOffset;
+    }
+
+    VKMemoryBlock* VKMemoryAllocator::createBlock(
+        const uint32_t memoryTypeIndex,
+        const VkDeviceSize size,
+        const bool linear,
+        const bool dedicated) {
+        auto block = std::make_unique<VKMemoryBlock>(VKMemoryBlock{
+            .size = size,
+            .memoryTypeIndex = memoryTypeIndex,
+            .linear = linear,
+            .dedicated = dedicated,
+        });
+        const auto allocInfo = VkMemoryAllocateInfo {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+            .allocationSize = size,
+            .memoryTypeIndex = memoryTypeIndex,
+        };
+        vkCheck(vkAllocateMemory(device, &allocInfo, nullptr, &block->memory));
+        if (memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+            vkCheck(vkMapMemory(device, block->memory, 0, VK_WHOLE_SIZE, 0, &block->mappedAddress));
+        }
+        block->freeRanges[0] = size;
+        heapAllocatedBytes[memoryProperties.memoryTypes[memoryTypeIndex].heapIndex].fetch_add(
+            size, std::memory_order_relaxed);
+#ifdef _DEBUG
+        vkSetObjectName(device, reinterpret_cast<uint64_t>(block->memory), VK_OBJECT_TYPE_DEVICE_MEMORY,
+            std::string("VKMemoryAllocator ") +
+            (dedicated ? "dedicated block" : linear ? "linear block" : "optimal block"));
+#endif
+        blocks[memoryTypeIndex].push_back(std::move(block));
+        return blocks[memoryTypeIndex].back().get();
+    }
+
+    void VKMemoryAllocator::destroyBlock(const VKMemoryBlock& block) const {
+        if (block.mappedAddress) {
+            vkUnmapMemory(device, block.memory);
+        }
+        vkFreeMemory(device, block.memory, nullptr);
+        heapAllocatedBytes[memoryProperties.memoryTypes[block.memoryTypeIndex].heapIndex].fetch_sub(
+            block.size, std::memory_order_relaxed);
+    }
+
+    VKMemoryStatistics VKMemoryAllocator::getStatistics() const {
+        auto lock = std::lock_guard(mutex);
+        auto statistics = VKMemoryStatistics{};
+        for (const auto& memoryTypeBlocks : blocks) {
+            for (const auto& block : memoryTypeBlocks) {
+                statistics.blockCount += 1;
+                statistics.dedicatedBlockCount += block->dedicated ? 1 : 0;
+                statistics.allocationCount += block->allocationCount;
+                statistics.blockBytes += block->size;
+                statistics.freeRangeCount += static_cast<uint32_t>(block->freeRanges.size());
+                for (const auto& range : block->freeRanges) {
+                    statistics.freeBytes += range.second;
+                    statistics.largestFreeRange = std::max(statistics.largestFreeRange, range.second);
+                }
+            }
+        }
+        statistics.allocatedBytes = statistics.blockBytes - statistics.freeBytes;
+        return statistics;
+    }
+
+    void VKDeletionQueue::setDeferredFrames(const uint32_t frames) {
+        auto lock = std::lock_guard(mutex);
+        deferredFrames = frames;
+    }
+
+    void VKDeletionQueue::push(std::function<void()> deleter) {
+        {
+            auto lock = std::lock_guard(mutex);
+            if (deferredFrames > 0) {
+                entries.push_back({ currentFrame, std::move(deleter) });
+                return;
+            }
+        }
+        deleter();
+    }
+
+    void VKDeletionQueue::collect() {
+        auto retired = std::vector<Entry>{};
+        {
+            auto lock = std::lock_guard(mutex);
+            currentFrame += 1;
+            while (!entries.empty() && entries.front().frame + deferredFrames <= currentFrame) {
+                retired.push_back(std::move(entries.front()));
+                entries.pop_front();
+            }
+        }
+        destroy(retired);
+    }
+
+    void VKDeletionQueue::flush() {
+        // A deleter can drop the last reference to an object queuing its own deleter
+        while (true) {
+            auto retired = std::vector<Entry>{};
+            {
+                auto lock = std::lock_guard(mutex);
+                if (entries.empty()) { return; }
+                std::ranges::move(entries, std::back_inserter(retired));
+                entries.clear();
+            }
+            destroy(retired);
+        }
+    }
+
+    void VKDeletionQueue::destroy(std::vector<Entry>& retired) {
+        for (auto& entry : retired) {
+            entry.deleter();
+        }
+    }
+
+    VKStagingRing::VKStagingRing(
+        const VkDevice device,
+        VKMemoryAllocator& allocator,
+        const VkDeviceSize size,
+        const VkDeviceSize alignment) :
+        device{device},
+        allocator{allocator},
+        size{size},
+        alignment{alignment} {
+        const auto bufferInfo = VkBufferCreateInfo {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+            .size = size,
+            .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        };
+        vkCheck(vkCreateBuffer(device, &bufferInfo, nullptr, &buffer));
+        VkMemoryRequirements memRequirements;
+        vkGetBufferMemoryRequirements(device, buffer, &memRequirements);
+        memory = allocator.allocate(
+            memRequirements,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            true);
+        vkCheck(vkBindBufferMemory(device, buffer, memory.memory, memory.offset));
+#ifdef _DEBUG
+        vkSetObjectName(device, reinterpret_cast<uint64_t>(buffer), VK_OBJECT_TYPE_BUFFER, "VKStagingRing");
+#endif
+    }
+
+    VKStagingRing::~VKStagingRing() {
+        vkDestroyBuffer(device, buffer, nullptr);
+        allocator.free(memory);
+    }
+
+    std::optional<VKStagingAllocation> VKStagingRing::allocate(
+        const VkDeviceSize allocationSize,
+        const VkDeviceSize alignment) {
+        assert(allocationSize > 0 && alignment > 0);
+        auto lock = std::lock_guard(mutex);
+        popReleased();
+        if (inFlight.empty()) {
+            head = 0;
+        }
+        const auto tail = inFlight.empty() ? 0 : inFlight.front().start;
+        const auto rangeAlignment = std::lcm(this->alignment, alignment);
+        const auto alignedHead = (head + rangeAlignment - 1) / rangeAlignment * rangeAlignment;
+        std::optional<VkDeviceSize> offset;
+        if (inFlight.empty() || head > tail) {
+            if (alignedHead + allocationSize <= size) {
+                offset = alignedHead;
+            } else if (allocationSize < tail) {
+                // Wrap around, the end of the ring is wasted until this range is released
+                offset = 0;
+            }
+        } else if (alignedHead + allocationSize < tail) {
+            offset = alignedHead;
+        }
+        if (!offset.has_value()) {
+            return {};
+        }
+        const auto id = nextId++;
+        inFlight.push_back({ .id = id, .start = head });
+        head = *offset + allocationSize;
+        return VKStagingAllocation{
+            .buffer = buffer,
+            .offset = *offset,
+            .size = allocationSize,
+            .mappedAddress = static_cast<std::byte*>(memory.mappedAddress) + *offset,
+            .id = id,
+        };
+    }
+
+    void VKStagingRing::release(const VKStagingAllocation& allocation) {
+        auto lock = std::lock_guard(mutex);
+        const auto it = std::ranges::find_if(inFlight, [&](const InFlightRange& range) {
+            return range.id == allocation.id;
+        });
+        assert(it != inFlight.end());
+        it->released = true;
+        popReleased();
+    }
+
+    void VKStagingRing::retire(const VKStagingAllocation& allocation, const VkSemaphore semaphore, const uint64_t value) {
+        auto lock = std::lock_guard(mutex);
+        const auto it = std::ranges::find_if(inFlight, [&](const InFlightRange& range) {
+            return range.id == allocation.id;
+        });
+        assert(it != inFlight.end() && !it->released);
+        // The values of a timeline semaphore only grow, the last submission finishes after the previous ones
+        const auto submission = std::ranges::find(it->submissions, semaphore, &std::pair<VkSemaphore, uint64_t>::first);
+        if (submission != it->submissions.end()) {
+            submission->second = value;
+        } else {
+            it->submissions.push_back({semaphore, value});
+        }
+    }
+
+    void VKStagingRing::releaseRetired(const VkSemaphore semaphore) {
+        auto lock = std::lock_guard(mutex);
+        for (auto& range : inFlight) {
+            std::erase_if(range.submissions, [semaphore](const auto& submission) {
+                return submission.first == semaphore;
+            });
+        }
+        popReleased();
+    }
+
+    void VKStagingRing::popReleased() {
+        // Only the oldest ranges free memory, the semaphores are read once per call
+        auto completedValues = std::vector<std::pair<VkSemaphore, uint64_t>>{};
+        while (!inFlight.empty()) {
+            auto& range = inFlight.front();
+            if (!range.released) { break; }
+            std::erase_if(range.submissions, [&](const std::pair<VkSemaphore, uint64_t>& submission) {
+                auto completed = std::ranges::find_if(completedValues, [&](const auto& completedValue) {
+                    return completedValue.first == submission.first;
+                });
+                if (completed == completedValues.end()) {
+                    auto value = uint64_t{0};
+                    vkCheck(vkGetSemaphoreCounterValue(device, submission.first, &value));
+                    completedValues.push_back({submission.first, value});
+                    completed = completedValues.end() - 1;
+                }
+                return completed->second >= submission.second;
+            });
+            if (!range.submissions.empty()) { break; }
+            inFlight.pop_front();
+        }
+    }
+
+}
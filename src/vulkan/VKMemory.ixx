@@ -0,0 +1,236 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+module;
+#include "vireo/backend/vulkan/Libraries.h"
+export module vireo.vulkan.memory;
+
+import std;
+
+export namespace vireo {
+
+    // Memory usage & fragmentation of the blocks managed by a VKMemoryAllocator
+    struct VKMemoryStatistics {
+        // Number of VkDeviceMemory allocated by the allocator, dedicated allocations included
+        uint32_t     blockCount{0};
+        // Number of dedicated VkDeviceMemory used by large resources
+        uint32_t     dedicatedBlockCount{0};
+        // Number of resources living in the blocks
+        uint32_t     allocationCount{0};
+        // Total size of the blocks
+        VkDeviceSize blockBytes{0};
+        // Total size used by the resources
+        VkDeviceSize allocatedBytes{0};
+        // Number of free ranges in all the blocks
+        uint32_t     freeRangeCount{0};
+        // Total size of the free ranges
+        VkDeviceSize freeBytes{0};
+        // Size of the largest free range
+        VkDeviceSize largestFreeRange{0};
+    };
+
+    // A VkDeviceMemory sub-allocated by a VKMemoryAllocator
+    struct VKMemoryBlock {
+        VkDeviceMemory memory{VK_NULL_HANDLE};
+        VkDeviceSize   size{0};
+        uint32_t       memoryTypeIndex{0};
+        // Linear (buffers) and optimal (images) resources never share a block
+        // so we don't have to deal with bufferImageGranularity
+        bool           linear{true};
+        // Block allocated for a single large resource
+        bool           dedicated{false};
+        // Persistent mapping of host visible blocks
+        void*          mappedAddress{nullptr};
+        uint32_t       allocationCount{0};
+        // Free ranges, size indexed by offset
+        std::map<VkDeviceSize, VkDeviceSize> freeRanges;
+    };
+
+    // A range of device memory inside a block
+    struct VKMemoryAllocation {
+        VkDeviceMemory memory{VK_NULL_HANDLE};
+        VkDeviceSize   offset{0};
+        VkDeviceSize   size{0};
+        // Host address of the range for host visible memory, nullptr otherwise
+        void*          mappedAddress{nullptr};
+        VKMemoryBlock* block{nullptr};
+    };
+
+    // Sub-allocates resources memory from large per-memory-type blocks to avoid hitting maxMemoryAllocationCount
+    class VKMemoryAllocator {
+    public:
+        // Default size of the blocks, heaps smaller than 1GB use 1/8 of the heap size
+        static constexpr VkDeviceSize DEFAULT_BLOCK_SIZE{256 * 1024 * 1024};
+
+        // `budgetSupported` is `true` if VK_EXT_memory_budget is enabled
+        VKMemoryAllocator(VkPhysicalDevice physicalDevice, VkDevice device, bool budgetSupported);
+
+        ~VKMemoryAllocator();
+
+        // Allocates memory for a resource and returns the memory range to bind the resource to,
+        // `dedicated` forces a block of its own
+        VKMemoryAllocation allocate(
+            const VkMemoryRequirements& requirements,
+            VkMemoryPropertyFlags properties,
+            bool linear,
+            bool dedicated = false);
+
+        // Returns a memory range to its block
+        void free(const VKMemoryAllocation& allocation);
+
+        // Find a specific memory type in the cached memory properties
+        uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+
+        // Returns true if one of the memory types have all the properties
+        bool isMemoryTypeAvailable(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+
+        const auto& getMemoryProperties() const { return memoryProperties; }
+
+        // Snapshot of the blocks, exposed by Vireo::getMemoryStatistics()
+        VKMemoryStatistics getStatistics() const;
+
+        // Returns true if `size` more bytes in a memory type keep its heap within the budget of the process
+        bool isWithinBudget(uint32_t memoryTypeIndex, VkDeviceSize size) const;
+
+        // Memory properties of a buffer written in place by the CPU : device local and host visible if one of the
+        // memory types in `typeFilter` have them and its heap stays within the budget, host visible otherwise
+        VkMemoryPropertyFlags getHostWriteProperties(uint32_t typeFilter, VkDeviceSize size) const;
+
+        // Size of the device memory allocated in a heap, read without locking the allocator
+        VkDeviceSize getHeapAllocatedBytes(const uint32_t heapIndex) const {
+            return heapAllocatedBytes[heapIndex].load(std::memory_order_relaxed);
+        }
+
+        VKMemoryAllocator(VKMemoryAllocator&) = delete;
+        VKMemoryAllocator& operator=(VKMemoryAllocator&) = delete;
+
+    private:
+        const VkPhysicalDevice           physicalDevice;
+        const VkDevice                   device;
+        const bool                       budgetSupported;
+        VkPhysicalDeviceMemoryProperties memoryProperties;
+        VkDeviceSize                     nonCoherentAtomSize;
+        // Blocks indexed by memory type index
+        std::vector<std::vector<std::unique_ptr<VKMemoryBlock>>> blocks;
+        mutable std::mutex               mutex;
+        // Size of the blocks indexed by heap index
+        mutable std::array<std::atomic<VkDeviceSize>, VK_MAX_MEMORY_HEAPS> heapAllocatedBytes{};
+
+        VkDeviceSize getBlockSize(uint32_t memoryTypeIndex) const;
+
+        VKMemoryBlock* createBlock(uint32_t memoryTypeIndex, VkDeviceSize size, bool linear, bool dedicated);
+
+        void destroyBlock(const VKMemoryBlock& block) const;
+
+        // Best fit search of a free range in a block, returns the aligned offset of the range
+        static std::optional<VkDeviceSize> allocateRange(
+            VKMemoryBlock& block,
+            VkDeviceSize size,
+            VkDeviceSize alignment);
+    };
+
+    // Destroys the GPU objects of the dropped resources once the frames that may use them are finished
+    class VKDeletionQueue {
+    public:
+        // Number of calls to collect() before destroying an object, 0 to destroy the objects immediately
+        void setDeferredFrames(uint32_t frames);
+
+        // Queues the destruction of GPU objects, or destroys them immediately if the queue is disabled
+        void push(std::function<void()> deleter);
+
+        // Ends a frame and destroys the retired objects
+        void collect();
+
+        // Destroys all the queued objects, the device must be idle
+        void flush();
+
+    private:
+        struct Entry {
+            uint64_t              frame;
+            std::function<void()> deleter;
+        };
+
+        uint32_t          deferredFrames{0};
+        uint64_t          currentFrame{0};
+        std::deque<Entry> entries;
+        std::mutex        mutex;
+
+        // Runs the deleters outside the lock since a deleter can queue other objects
+        static void destroy(std::vector<Entry>& retired);
+    };
+
+    // A range of the staging ring
+    struct VKStagingAllocation {
+        VkBuffer     buffer{VK_NULL_HANDLE};
+        VkDeviceSize offset{0};
+        VkDeviceSize size{0};
+        void*        mappedAddress{nullptr};
+        uint64_t     id{0};
+    };
+
+    // Persistently mapped host visible buffer sub-allocated linearly for the host to device transfers.
+    // A range is recycled once its command list has released it and all the submissions using it are finished,
+    // the submit queues retire the ranges with the timeline value of each submission. The oldest ranges are
+    // recycled first.
+    class VKStagingRing {
+    public:
+        static constexpr VkDeviceSize DEFAULT_SIZE{64 * 1024 * 1024};
+
+        VKStagingRing(VkDevice device, VKMemoryAllocator& allocator, VkDeviceSize size, VkDeviceSize alignment);
+
+        ~VKStagingRing();
+
+        // Returns a range of the ring or nothing if the ring is full. The offset of the range is aligned on the ring
+        // alignment and on `alignment`, which can be a texel size that is not a power of two
+        std::optional<VKStagingAllocation> allocate(VkDeviceSize allocationSize, VkDeviceSize alignment = 1);
+
+        // Releases a range once the submissions using it are finished,
+        // the memory is reused when all the older ranges have been released
+        void release(const VKStagingAllocation& allocation);
+
+        // Adds a submission using a range, finished when a timeline semaphore reaches a value.
+        // A later submission signaling the same semaphore replaces the previous one.
+        void retire(const VKStagingAllocation& allocation, VkSemaphore semaphore, uint64_t value);
+
+        // Forgets the submissions signaling a semaphore before its destruction, they must be finished
+        void releaseRetired(VkSemaphore semaphore);
+
+        auto getSize() const { return size; }
+
+        // Alignment of the ranges offsets, suitable for buffer to image copies
+        auto getAlignment() const { return alignment; }
+
+        VKStagingRing(VKStagingRing&) = delete;
+        VKStagingRing& operator=(VKStagingRing&) = delete;
+
+    private:
+        struct InFlightRange {
+            uint64_t     id;
+            // Start of the range, alignment padding and wasted end of the ring included
+            VkDeviceSize start;
+            // The command list using the range does not need it anymore
+            bool         released{false};
+            // Timeline semaphores & values of the submissions using the range, one per submit queue
+            std::vector<std::pair<VkSemaphore, uint64_t>> submissions;
+        };
+
+        const VkDevice             device;
+        VKMemoryAllocator&         allocator;
+        const VkDeviceSize         size;
+        const VkDeviceSize         alignment;
+        VkBuffer                   buffer{VK_NULL_HANDLE};
+        VKMemoryAllocation         memory{};
+        // Next free byte, the used bytes are between the start of the oldest range and head
+        VkDeviceSize               head{0};
+        uint64_t                   nextId{1};
+        std::deque<InFlightRange>  inFlight;
+        std::mutex                 mutex;
+
+        // Pops the oldest ranges released or whose submission is finished, the mutex must be locked
+        void popReleased();
+    };
+
+}
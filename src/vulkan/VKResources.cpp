@@ -15,12 +15,125 @@ import vireo.vulkan.tools;
 
 namespace vireo {
 
+    VKMemoryHeap::VKMemoryHeap(
+        const std::shared_ptr<const VKDevice>& device,
+        const size_t size,
+        const MemoryHeapUsage usage,
+        const std::wstring& name) :
+        MemoryHeap{size, usage},
+        device{device} {
+        // The heap gets its own device memory in a memory type accepted by all the resources it can hold
+        const auto requirements = VkMemoryRequirements {
+            .size = (size + PLACEMENT_ALIGNMENT - 1) & ~(PLACEMENT_ALIGNMENT - 1),
+            .alignment = MSAA_PLACEMENT_ALIGNMENT,
+            .memoryTypeBits = getMemoryTypeBits(device->getDevice(), usage),
+        };
+        auto& allocator = device->getMemoryAllocator();
+        if (!allocator.isMemoryTypeAvailable(requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
+            throw Exception("No device local memory type for the resources of the memory heap");
+        }
+        memory = allocator.allocate(
+            requirements,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            usage == MemoryHeapUsage::BUFFERS,
+            true);
+#ifdef _DEBUG
+        vkSetObjectName(device->getDevice(), reinterpret_cast<uint64_t>(memory.memory), VK_OBJECT_TYPE_DEVICE_MEMORY,
+            "VKMemoryHeap : " + to_string(name));
+#endif
+    }
+
+    uint32_t VKMemoryHeap::getMemoryTypeBits(const VkDevice device, const MemoryHeapUsage usage) {
+        // The memory types of a resource only depend on its class (buffer, optimal image, depth/stencil attachment),
+        // like the DirectX heap flags, so small probe resources give the memory types of the whole class
+        auto memoryTypeBits = ~0u;
+        const auto probeImage = [&](const VkFormat format, const VkImageUsageFlags imageUsage) {
+            const auto imageInfo = VkImageCreateInfo {
+                .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+                .imageType = VK_IMAGE_TYPE_2D,
+                .format = format,
+                .extent = {16, 16, 1},
+                .mipLevels = 1,
+                .arrayLayers = 1,
+                .samples = VK_SAMPLE_COUNT_1_BIT,
+                .tiling = VK_IMAGE_TILING_OPTIMAL,
+                .usage = imageUsage,
+                .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+                .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+            };
+            VkImage image;
+            vkCheck(vkCreateImage(device, &imageInfo, nullptr, &image));
+            VkMemoryRequirements requirements;
+            vkGetImageMemoryRequirements(device, image, &requirements);
+            vkDestroyImage(device, image, nullptr);
+            memoryTypeBits &= requirements.memoryTypeBits;
+        };
+        if (usage == MemoryHeapUsage::ALL || usage == MemoryHeapUsage::BUFFERS) {
+            const auto bufferInfo = VkBufferCreateInfo {
+                .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+                .size = PLACEMENT_ALIGNMENT,
+                .usage =
+                    VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+                    VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                    VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+            };
+            VkBuffer buffer;
+            vkCheck(vkCreateBuffer(device, &bufferInfo, nullptr, &buffer));
+            VkMemoryRequirements requirements;
+            vkGetBufferMemoryRequirements(device, buffer, &requirements);
+            vkDestroyBuffer(device, buffer, nullptr);
+            memoryTypeBits &= requirements.memoryTypeBits;
+        }
+        if (usage == MemoryHeapUsage::ALL || usage == MemoryHeapUsage::IMAGES) {
+            probeImage(VK_FORMAT_R8G8B8A8_UNORM,
+                VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT |
+                VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+        }
+        if (usage == MemoryHeapUsage::ALL || usage == MemoryHeapUsage::RENDER_TARGETS) {
+            probeImage(VK_FORMAT_R8G8B8A8_UNORM,
+                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+            probeImage(VK_FORMAT_D32_SFLOAT,
+                VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
+        }
+        return memoryTypeBits;
+    }
+
+    VKMemoryHeap::~VKMemoryHeap() {
+        device->getDeletionQueue().push([&allocator = device->getMemoryAllocator(), memory = memory] {
+            allocator.free(memory);
+        });
+    }
+
+    VKMemoryAllocation VKMemoryHeap::place(const VkMemoryRequirements& requirements, const VkDeviceSize offset) const {
+        if (!(requirements.memoryTypeBits & (1 << memory.block->memoryTypeIndex))) {
+            throw Exception("Resource memory type not compatible with the memory heap");
+        }
+        if ((memory.offset + offset) % requirements.alignment != 0) {
+            throw Exception("Resource placed at an unaligned offset of the memory heap");
+        }
+        if (offset + requirements.size > getSize()) {
+            throw Exception("Resource does not fit in the memory heap");
+        }
+        return {
+            .memory = memory.memory,
+            .offset = memory.offset + offset,
+            .size = requirements.size,
+        };
+    }
+
     VKBuffer::VKBuffer(
             const std::shared_ptr<const VKDevice>& device,
             const BufferType type,
             const size_t size,
             const size_t count,
-            const std::wstring& name) : Buffer{type},device{device} {
+            const std::wstring& name,
+            const bool persistent,
+            const uint32_t versionCount,
+            const BufferUsage additionalUsage,
+            const std::shared_ptr<const VKMemoryHeap>& heap,
+            const size_t heapOffset) : Buffer{type, additionalUsage},device{device}, heap{heap} {
+        assert(versionCount > 0);
         auto minOffsetAlignment = 0;
         if (type == BufferType::UNIFORM) {
             minOffsetAlignment = device->getPhysicalDevice().getDeviceProperties().limits.minUniformBufferOffsetAlignment;
@@ -31,62 +144,235 @@ namespace vireo {
         bufferSize = instanceSizeAligned * count;
         instanceSize = size;
         instanceCount = count;
+        persistentlyMapped = persistent;
+        this->versionCount = versionCount;
+        // Each copy of the content must be usable with a UNIFORM_DYNAMIC offset
+        const auto versionAlignment = versionCount > 1 ?
+            device->getPhysicalDevice().getDeviceProperties().limits.minUniformBufferOffsetAlignment :
+            VkDeviceSize{1};
+        versionSize = (bufferSize + versionAlignment - 1) & ~(versionAlignment - 1);
 
-        const VkBufferCreateFlags usage =
-            type == BufferType::VERTEX ? VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT :
-            type == BufferType::INDEX ? VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT:
-            type == BufferType::INDIRECT ? VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT:
-            type == BufferType::STORAGE ? VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT:
-            type == BufferType::DEVICE_STORAGE ? VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT:
-            type == BufferType::READWRITE_STORAGE ? VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT:
-            type == BufferType::IMAGE_UPLOAD ? VK_BUFFER_USAGE_TRANSFER_SRC_BIT:
-            type == BufferType::IMAGE_DOWNLOAD ? VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT:
-            type == BufferType::BUFFER_UPLOAD ? VK_BUFFER_USAGE_TRANSFER_SRC_BIT:
-            type == BufferType::BUFFER_DOWNLOAD ? VK_BUFFER_USAGE_TRANSFER_DST_BIT:
-            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
-        const auto memType = (
+        const VkBufferUsageFlags usage = getTypeUsage(type) |
+            (hasUsage(BufferUsage::VERTEX) ? VK_BUFFER_USAGE_VERTEX_BUFFER_BIT : 0) |
+            (hasUsage(BufferUsage::INDEX) ? VK_BUFFER_USAGE_INDEX_BUFFER_BIT : 0) |
+            (hasUsage(BufferUsage::INDIRECT) ? VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT : 0) |
+            (hasUsage(BufferUsage::UNIFORM) ? VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT : 0) |
+            (hasUsage(BufferUsage::STORAGE | BufferUsage::READWRITE_STORAGE) ? VK_BUFFER_USAGE_STORAGE_BUFFER_BIT : 0) |
+            (hasUsage(BufferUsage::TRANSFER_SRC) ? VK_BUFFER_USAGE_TRANSFER_SRC_BIT : 0) |
+            (hasUsage(BufferUsage::TRANSFER_DST) ? VK_BUFFER_USAGE_TRANSFER_DST_BIT : 0);
+        auto memType = VkMemoryPropertyFlags{(
             type == BufferType::VERTEX ||
             type == BufferType::INDEX ||
             type == BufferType::INDIRECT ||
             type == BufferType::DEVICE_STORAGE ||
             type == BufferType::READWRITE_STORAGE) ?
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT :
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-        createBuffer(device, bufferSize, usage, memType, buffer, bufferMemory);
-        if constexpr (isMemoryUsageEnabled()) {
-            auto lock = std::lock_guard(memoryAllocationsMutex);
-            memoryAllocations.push_back({
-                VideoMemoryAllocationUsage::BUFFER,
-                name,
-                bufferSize,
-                buffer });
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT};
+        auto& allocator = device->getMemoryAllocator();
+        VkMemoryRequirements memRequirements;
+        createBuffer(device, versionSize * versionCount, usage, buffer, memRequirements);
+        // The CPU reads the download buffers, uncached memory makes each read go over the bus.
+        // Most devices only have non-coherent cached memory, read after an invalidate()
+        if (type == BufferType::IMAGE_DOWNLOAD || type == BufferType::BUFFER_DOWNLOAD) {
+            if (allocator.isMemoryTypeAvailable(
+                memRequirements.memoryTypeBits, memType | VK_MEMORY_PROPERTY_HOST_CACHED_BIT)) {
+                memType |= VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+            } else if (allocator.isMemoryTypeAvailable(
+                memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT)) {
+                memType = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+            }
+        }
+        if (hasUsage(BufferUsage::HOST_WRITE)) {
+            assert(type != BufferType::IMAGE_DOWNLOAD && type != BufferType::BUFFER_DOWNLOAD);
+            memType = heap ?
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT :
+                allocator.getHostWriteProperties(memRequirements.memoryTypeBits, memRequirements.size);
+        }
+        bufferMemory = heap ?
+            heap->place(memRequirements, heapOffset) :
+            allocator.allocate(memRequirements, memType, true);
+        vkCheck(vkBindBufferMemory(device->getDevice(), buffer, bufferMemory.memory, bufferMemory.offset));
+        trackMemoryUsage(bufferMemory.size);
+        // On UMA devices the host visible memory types are also device local
+        const auto memoryTypeProperties = bufferMemory.block ?
+            allocator.getMemoryProperties().memoryTypes[bufferMemory.block->memoryTypeIndex].propertyFlags :
+            memType;
+        deviceLocal = (memoryTypeProperties & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) != 0;
+        hostCoherent =
+            !(memoryTypeProperties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) ||
+            (memoryTypeProperties & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        if (persistentlyMapped) {
+            mappedAddress = bufferMemory.mappedAddress;
         }
 #ifdef _DEBUG
         vkSetObjectName(device->getDevice(), reinterpret_cast<uint64_t>(buffer), VK_OBJECT_TYPE_BUFFER,
             "VKBuffer : " + to_string(name));
-        vkSetObjectName(device->getDevice(), reinterpret_cast<uint64_t>(bufferMemory), VK_OBJECT_TYPE_DEVICE_MEMORY,
-        "VKBuffer Memory : " + to_string(name));
 #endif
     }
 
+    VKBuffer::VKBuffer(
+            const std::shared_ptr<const VKDevice>& device,
+            const BufferType type,
+            void* hostAddress,
+            const size_t size,
+            const std::wstring& name) : Buffer{type}, device{device}, importedMemory{true} {
+        assert(hostAddress != nullptr);
+        if (type != BufferType::UNIFORM &&
+            type != BufferType::STORAGE &&
+            type != BufferType::IMAGE_UPLOAD &&
+            type != BufferType::BUFFER_UPLOAD &&
+            type != BufferType::IMAGE_DOWNLOAD &&
+            type != BufferType::BUFFER_DOWNLOAD) {
+            throw Exception("Only host accessible buffer types can use host memory");
+        }
+        instanceSizeAligned = size;
+        bufferSize = size;
+        instanceSize = size;
+        instanceCount = 1;
+        versionSize = size;
+        // The host pages are always accessible by the CPU
+        persistentlyMapped = true;
+        mappedAddress = hostAddress;
+
+        const auto vkDevice = device->getDevice();
+        const auto externalMemoryInfo = VkExternalMemoryBufferCreateInfo {
+            .sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO,
+            .handleTypes = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT,
+        };
+        const auto bufferInfo = VkBufferCreateInfo {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+            .pNext = &externalMemoryInfo,
+            .size = size,
+            .usage = getTypeUsage(type),
+            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        };
+        vkCheck(vkCreateBuffer(vkDevice, &bufferInfo, nullptr, &buffer));
+        // The destructor isn't called if the import fails, release what has been created so far
+        struct ImportGuard {
+            const VkDevice  device;
+            VkBuffer&       buffer;
+            VkDeviceMemory& memory;
+            bool            imported{false};
+            ~ImportGuard() {
+                if (imported) { return; }
+                if (memory != VK_NULL_HANDLE) {
+                    vkFreeMemory(device, memory, nullptr);
+                }
+                vkDestroyBuffer(device, buffer, nullptr);
+            }
+        } importGuard{vkDevice, buffer, bufferMemory.memory};
+        VkMemoryRequirements memRequirements;
+        vkGetBufferMemoryRequirements(vkDevice, buffer, &memRequirements);
+        auto hostPointerProperties = VkMemoryHostPointerPropertiesEXT {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_HOST_POINTER_PROPERTIES_EXT,
+        };
+        vkCheck(vkGetMemoryHostPointerPropertiesEXT(
+            vkDevice,
+            VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT,
+            hostAddress,
+            &hostPointerProperties));
+        if (memRequirements.size > size) {
+            throw Exception("Host memory too small for the buffer");
+        }
+        const auto& allocator = device->getMemoryAllocator();
+        const auto memoryTypeIndex = allocator.findMemoryType(
+            memRequirements.memoryTypeBits & hostPointerProperties.memoryTypeBits,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+        hostCoherent = (allocator.getMemoryProperties().memoryTypes[memoryTypeIndex].propertyFlags &
+            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+        const auto importInfo = VkImportMemoryHostPointerInfoEXT {
+            .sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_HOST_POINTER_INFO_EXT,
+            .handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT,
+            .pHostPointer = hostAddress,
+        };
+        const auto allocInfo = VkMemoryAllocateInfo {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+            .pNext = &importInfo,
+            .allocationSize = size,
+            .memoryTypeIndex = memoryTypeIndex,
+        };
+        vkCheck(vkAllocateMemory(vkDevice, &allocInfo, nullptr, &bufferMemory.memory));
+        bufferMemory.size = size;
+        bufferMemory.mappedAddress = hostAddress;
+        vkCheck(vkBindBufferMemory(vkDevice, buffer, bufferMemory.memory, 0));
+        importGuard.imported = true;
+        // Not counted in the memory usage : the pages belong to the application
+#ifdef _DEBUG
+        vkSetObjectName(vkDevice, reinterpret_cast<uint64_t>(buffer), VK_OBJECT_TYPE_BUFFER,
+            "VKBuffer : " + to_string(name));
+#endif
+    }
+
+    VkBufferUsageFlags VKBuffer::getTypeUsage(const BufferType type) {
+        return
+            type == BufferType::VERTEX ? VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT :
+            type == BufferType::INDEX ? VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT:
+            type == BufferType::INDIRECT ? VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT:
+            type == BufferType::STORAGE ? VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT:
+            type == BufferType::DEVICE_STORAGE ? VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT:
+            type == BufferType::READWRITE_STORAGE ? VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT:
+            type == BufferType::IMAGE_UPLOAD ? VK_BUFFER_USAGE_TRANSFER_SRC_BIT:
+            type == BufferType::IMAGE_DOWNLOAD ? VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT:
+            type == BufferType::BUFFER_UPLOAD ? VK_BUFFER_USAGE_TRANSFER_SRC_BIT:
+            type == BufferType::BUFFER_DOWNLOAD ? VK_BUFFER_USAGE_TRANSFER_DST_BIT:
+            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+    }
+
     void VKBuffer::map() {
+        if (persistentlyMapped) { return; }
         assert(mappedAddress == nullptr);
-        vkMapMemory(device->getDevice(), bufferMemory, 0, bufferSize, 0, &mappedAddress);
+        // Host visible memory blocks are persistently mapped by the allocator
+        assert(bufferMemory.mappedAddress != nullptr);
+        mappedAddress = static_cast<std::byte*>(bufferMemory.mappedAddress) + getCurrentOffset();
+        // The download buffers use cached memory, often non-coherent : the host would read stale cache lines
+        if (getType() == BufferType::IMAGE_DOWNLOAD || getType() == BufferType::BUFFER_DOWNLOAD) {
+            invalidate();
+        }
     }
 
     void VKBuffer::unmap() {
+        if (persistentlyMapped) { return; }
         assert(mappedAddress != nullptr);
-        vkUnmapMemory(device->getDevice(), bufferMemory);
         mappedAddress = nullptr;
     }
 
+    void VKBuffer::flush(const size_t offset, const size_t size) const {
+        if (hostCoherent) { return; }
+        const auto range = getMappedRange(offset, size);
+        vkCheck(vkFlushMappedMemoryRanges(device->getDevice(), 1, &range));
+    }
+
+    void VKBuffer::invalidate(const size_t offset, const size_t size) const {
+        if (hostCoherent) { return; }
+        const auto range = getMappedRange(offset, size);
+        vkCheck(vkInvalidateMappedMemoryRanges(device->getDevice(), 1, &range));
+    }
+
+    VkMappedMemoryRange VKBuffer::getMappedRange(const size_t offset, const size_t size) const {
+        assert(mappedAddress != nullptr);
+        // The allocator aligns the non-coherent allocations on nonCoherentAtomSize,
+        // the range can be extended to whole atoms without touching other resources
+        const auto atomSize = device->getPhysicalDevice().getDeviceProperties().limits.nonCoherentAtomSize;
+        const auto start = bufferMemory.offset + getCurrentOffset() + offset;
+        const auto end = size == WHOLE_SIZE ? bufferMemory.offset + bufferMemory.size : start + size;
+        const auto alignedStart = start & ~(atomSize - 1);
+        const auto alignedEnd = std::min(
+            (end + atomSize - 1) & ~(atomSize - 1),
+            bufferMemory.offset + bufferMemory.size);
+        return {
+            .sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+            .memory = bufferMemory.memory,
+            .offset = alignedStart,
+            .size = alignedEnd - alignedStart,
+        };
+    }
+
     void VKBuffer::createBuffer(
             const std::shared_ptr<const VKDevice>& device,
             const VkDeviceSize size,
             const VkBufferUsageFlags usage,
-            const VkMemoryPropertyFlags memoryTypeIndex,
             VkBuffer& buffer,
-            VkDeviceMemory& memory) {
+            VkMemoryRequirements& memRequirements) {
         const auto bufferInfo = VkBufferCreateInfo {
             .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
             .size = size,
@@ -94,29 +380,32 @@ namespace vireo {
             .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
         };
         vkCheck(vkCreateBuffer(device->getDevice(), &bufferInfo, nullptr, &buffer));
-        VkMemoryRequirements memRequirements;
         vkGetBufferMemoryRequirements(device->getDevice(), buffer, &memRequirements);
-        const auto allocInfo = VkMemoryAllocateInfo {
-            .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-            .allocationSize = memRequirements.size,
-            .memoryTypeIndex = device->getPhysicalDevice().findMemoryType(memRequirements.memoryTypeBits, memoryTypeIndex)
-        };
-        vkCheck(vkAllocateMemory(device->getDevice(), &allocInfo, nullptr, &memory));
-        vkBindBufferMemory(device->getDevice(), buffer, memory, 0);
     }
 
     VKBuffer::~VKBuffer() {
         if (mappedAddress) {
             VKBuffer::unmap();
         }
-        // if constexpr(isMemoryUsageEnabled()) {
-            // auto lock = std::lock_guard(memoryAllocationsMutex);
-            // memoryAllocations.remove_if([&](const VideoMemoryAllocationDesc& usage) {
-                // return usage.ref == buffer;
-            // });
-        // }
-        vkDestroyBuffer(device->getDevice(), buffer, nullptr);
-        vkFreeMemory(device->getDevice(), bufferMemory, nullptr);
+        // The deleters never hold the device or the heap, a queue never flushed would keep them alive.
+        // The heap of a placed buffer queues its own deleter after this one and the queue runs them in order
+        device->getDeletionQueue().push([
+            vkDevice = device->getDevice(),
+            &allocator = device->getMemoryAllocator(),
+            buffer = buffer,
+            memory = bufferMemory,
+            placed = heap != nullptr,
+            importedMemory = importedMemory,
+            type = getType(),
+            trackedSize = detachMemoryUsage()] {
+            vkDestroyBuffer(vkDevice, buffer, nullptr);
+            if (importedMemory) {
+                vkFreeMemory(vkDevice, memory.memory, nullptr);
+            } else if (!placed) {
+                allocator.free(memory);
+            }
+            untrackMemoryUsage(type, trackedSize);
+        });
     }
 
     VKSampler::VKSampler(
@@ -170,10 +459,29 @@ namespace vireo {
         const bool        isRenderTarget,
         const bool        isDepthBuffer,
         const bool        isDepthBufferWithStencil,
-        const MSAA        msaa):
-        Image{format, width, height, mipLevels, arraySize, useByComputeShader},
-        device{device} {
-        const VkImageUsageFlags usage =
+        const MSAA        msaa,
+        const ImageUsage  imageUsage,
+        const std::shared_ptr<const VKMemoryHeap>& heap,
+        const size_t      heapOffset):
+        Image{format, width, height, mipLevels, arraySize, useByComputeShader, imageUsage},
+        device{device},
+        samples{VKPhysicalDevice::vkSampleCountFlag[static_cast<int>(msaa)]},
+        heap{heap} {
+        const VkImageUsageFlags attachmentUsage =
+            isDepthBuffer ? VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT : VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        assert(!hasUsage(ImageUsage::TRANSIENT) || (isRenderTarget && imageUsage == ImageUsage::TRANSIENT));
+        const auto explicitUsage = hasUsage(
+            ImageUsage::SAMPLED | ImageUsage::STORAGE | ImageUsage::TRANSFER_SRC |
+            ImageUsage::TRANSFER_DST | ImageUsage::ATTACHMENT);
+        const VkImageUsageFlags baseUsage =
+            hasUsage(ImageUsage::TRANSIENT) ? attachmentUsage | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT :
+            explicitUsage ?
+                // Only request what the application declared so the driver can compress attachments
+                (isRenderTarget || hasUsage(ImageUsage::ATTACHMENT) ? attachmentUsage : 0) |
+                (hasUsage(ImageUsage::SAMPLED) ? VK_IMAGE_USAGE_SAMPLED_BIT : 0) |
+                (hasUsage(ImageUsage::STORAGE) ? VK_IMAGE_USAGE_STORAGE_BIT : 0) |
+                (hasUsage(ImageUsage::TRANSFER_SRC) ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT : 0) |
+                (hasUsage(ImageUsage::TRANSFER_DST) ? VK_IMAGE_USAGE_TRANSFER_DST_BIT : 0) :
             isRenderTarget ?
                 isDepthBuffer ?
                     msaa != MSAA::NONE ? VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT :
@@ -181,6 +489,13 @@ namespace vireo {
                     : VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_SAMPLED_BIT:
             useByComputeShader ? VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT:
             VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        if (hasUsage(ImageUsage::HOST_TRANSFER) && (
+            !device->getPhysicalDevice().isHostImageCopySupported() ||
+            !device->getPhysicalDevice().isHostImageCopyFormatSupported(vkFormats[static_cast<int>(format)]))) {
+            throw Exception("Host copies not supported for this image format");
+        }
+        const VkImageUsageFlags usage = baseUsage |
+            (hasUsage(ImageUsage::HOST_TRANSFER) ? VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT : 0);
         const VkImageCreateFlags flags = arraySize == 6 ? VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT : 0;
         const auto imageInfo = VkImageCreateInfo {
             .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
@@ -190,7 +505,7 @@ namespace vireo {
             .extent = {width, height, 1},
             .mipLevels = mipLevels,
             .arrayLayers = arraySize,
-            .samples = VKPhysicalDevice::vkSampleCountFlag[static_cast<int>(msaa)],
+            .samples = samples,
             .tiling = VK_IMAGE_TILING_OPTIMAL,
             .usage = usage,
             .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
@@ -205,28 +520,26 @@ namespace vireo {
         VkMemoryRequirements memRequirements;
         vkGetImageMemoryRequirements(device->getDevice(), image, &memRequirements);
 
-        const auto allocInfo = VkMemoryAllocateInfo {
-            .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-            .allocationSize = memRequirements.size,
-            .memoryTypeIndex = device->getPhysicalDevice().findMemoryType(
-                memRequirements.memoryTypeBits,
-                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
-        };
-        vkCheck(vkAllocateMemory(device->getDevice(), &allocInfo, nullptr, &imageMemory));
-        vkCheck(vkBindImageMemory(device->getDevice(), image, imageMemory, 0));
-        if constexpr (isMemoryUsageEnabled()) {
-            auto lock = std::lock_guard(memoryAllocationsMutex);
-            memoryAllocations.push_back({
-                VideoMemoryAllocationUsage::IMAGE,
-                name,
-                allocInfo.allocationSize,
-                image });
-        }
-#ifdef _DEBUG
-        vkSetObjectName(device->getDevice(), reinterpret_cast<uint64_t>(imageMemory), VK_OBJECT_TYPE_DEVICE_MEMORY,
-        "VKImage Memory : " + to_string(name));
-#endif
+        // Transient attachments use lazily allocated memory when available (mostly tile-based GPUs)
+        // and fall back to regular device memory
+        constexpr VkMemoryPropertyFlags lazyMemoryProperties =
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+        const auto useLazyMemory =
+            hasUsage(ImageUsage::TRANSIENT) &&
+            device->getMemoryAllocator().isMemoryTypeAvailable(memRequirements.memoryTypeBits, lazyMemoryProperties);
+        imageMemory = heap ?
+            heap->place(memRequirements, heapOffset) :
+            device->getMemoryAllocator().allocate(
+                memRequirements,
+                useLazyMemory ? lazyMemoryProperties : VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                false);
+        vkCheck(vkBindImageMemory(device->getDevice(), image, imageMemory.memory, imageMemory.offset));
+        trackMemoryUsage(imageMemory.size);
 
+        if (!(usage & (VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT | attachmentUsage))) {
+            // Transfer-only images can't have a view
+            return;
+        }
         const auto aspect = isDepthBuffer ?
             isDepthBufferWithStencil ?
             VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT:
@@ -253,15 +566,22 @@ namespace vireo {
     }
 
     VKImage::~VKImage() {
-        // if constexpr(isMemoryUsageEnabled()) {
-            // auto lock = std::lock_guard(memoryAllocationsMutex);
-            // memoryAllocations.remove_if([&](const VideoMemoryAllocationDesc& usage) {
-                // return usage.ref == image;
-            // });
-        // }
-        vkDestroyImage(device->getDevice(), image, nullptr);
-        vkFreeMemory(device->getDevice(), imageMemory, nullptr);
-        vkDestroyImageView(device->getDevice(), imageView, nullptr);
+        // Like VKBuffer the deleter doesn't hold the heap, its own deleter is queued after this one
+        device->getDeletionQueue().push([
+            vkDevice = device->getDevice(),
+            &allocator = device->getMemoryAllocator(),
+            image = image,
+            imageView = imageView,
+            memory = imageMemory,
+            placed = heap != nullptr,
+            trackedSize = detachMemoryUsage()] {
+            vkDestroyImageView(vkDevice, imageView, nullptr);
+            vkDestroyImage(vkDevice, image, nullptr);
+            if (!placed) {
+                allocator.free(memory);
+            }
+            untrackMemoryUsage(trackedSize);
+        });
     }
 
 
@@ -11,9 +11,31 @@ export module vireo.vulkan.resources;
 import vireo;
 
 import vireo.vulkan.devices;
+import vireo.vulkan.memory;
 
 export namespace vireo {
 
+    class VKMemoryHeap : public MemoryHeap {
+    public:
+        VKMemoryHeap(
+            const std::shared_ptr<const VKDevice>& device,
+            size_t size,
+            MemoryHeapUsage usage,
+            const std::wstring& name);
+
+        ~VKMemoryHeap() override;
+
+        // Returns the memory range of a resource placed at an offset of the heap
+        VKMemoryAllocation place(const VkMemoryRequirements& requirements, VkDeviceSize offset) const;
+
+    private:
+        const std::shared_ptr<const VKDevice> device;
+        VKMemoryAllocation memory{};
+
+        // Returns the memory types accepted by all the resources of a class
+        static uint32_t getMemoryTypeBits(VkDevice device, MemoryHeapUsage usage);
+    };
+
     class VKBuffer : public Buffer {
     public:
         VKBuffer(
@@ -21,7 +43,20 @@ export namespace vireo {
             BufferType type,
             size_t size,
             size_t count,
-            const std::wstring& name = L"");
+            const std::wstring& name = L"",
+            bool persistent = false,
+            uint32_t versionCount = 1,
+            BufferUsage additionalUsage = BufferUsage::NONE,
+            const std::shared_ptr<const VKMemoryHeap>& heap = nullptr,
+            size_t heapOffset = 0);
+
+        // Buffer using existing host memory, imported with VK_EXT_external_memory_host
+        VKBuffer(
+            const std::shared_ptr<const VKDevice>& device,
+            BufferType type,
+            void* hostAddress,
+            size_t size,
+            const std::wstring& name);
 
         ~VKBuffer() override;
 
@@ -29,20 +64,33 @@ export namespace vireo {
 
         void unmap() override;
 
+        void flush(size_t offset = 0, size_t size = WHOLE_SIZE) const override;
+
+        void invalidate(size_t offset = 0, size_t size = WHOLE_SIZE) const override;
+
         inline auto getBuffer() const { return buffer; }
 
     private:
         const std::shared_ptr<const VKDevice> device;
-        VkBuffer       buffer{VK_NULL_HANDLE};
-        VkDeviceMemory bufferMemory{VK_NULL_HANDLE};
+        VkBuffer           buffer{VK_NULL_HANDLE};
+        VKMemoryAllocation bufferMemory{};
+        // Heap of a placed buffer
+        const std::shared_ptr<const VKMemoryHeap> heap;
+        // Dedicated memory of an imported host buffer, not managed by the allocator
+        const bool         importedMemory{false};
+
+        static VkBufferUsageFlags getTypeUsage(BufferType type);
 
+        // Range of the memory to flush or invalidate, extended to whole non-coherent atoms
+        VkMappedMemoryRange getMappedRange(size_t offset, size_t size) const;
+
+        // Creates the buffer and returns its memory requirements, the memory type is selected from them
         static void createBuffer(
             const std::shared_ptr<const VKDevice>& device,
             VkDeviceSize size,
             VkBufferUsageFlags usage,
-            uint32_t memoryTypeIndex,
             VkBuffer& buffer,
-            VkDeviceMemory& memory);
+            VkMemoryRequirements& memRequirements);
     };
 
     class VKSampler : public Sampler {
@@ -163,7 +211,10 @@ export namespace vireo {
             bool isRenderTarget,
             bool isDepthBuffer,
             bool isDepthBufferWithStencil,
-            MSAA msaa);
+            MSAA msaa,
+            ImageUsage imageUsage = ImageUsage::DEFAULT,
+            const std::shared_ptr<const VKMemoryHeap>& heap = nullptr,
+            size_t heapOffset = 0);
 
         ~VKImage() override;
 
@@ -171,11 +222,16 @@ export namespace vireo {
 
         auto getImageView() const { return imageView; }
 
+        auto getSamples() const { return samples; }
+
     private:
         const std::shared_ptr<const VKDevice> device;
-        VkImage        image{VK_NULL_HANDLE};
-        VkDeviceMemory imageMemory{VK_NULL_HANDLE};
-        VkImageView    imageView{VK_NULL_HANDLE};
+        const VkSampleCountFlagBits samples;
+        VkImage            image{VK_NULL_HANDLE};
+        VKMemoryAllocation imageMemory{};
+        VkImageView        imageView{VK_NULL_HANDLE};
+        // Heap of a placed image
+        const std::shared_ptr<const VKMemoryHeap> heap;
     };
 
 }
\ No newline at end of file
@@ -31,6 +31,8 @@ export namespace vireo {
 
         auto getCurrentImageView() const { return swapChainImageViews[imageIndex[currentFrameIndex]]; }
 
+        auto getImageFormat() const { return swapChainImageFormat; }
+
         void nextFrameIndex() override;
 
         bool acquire(const std::shared_ptr<Fence>& fence) override;
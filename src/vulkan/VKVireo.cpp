@@ -6,6 +6,7 @@
 */
 module;
 #include "vireo/backend/vulkan/Libraries.h"
+#include <cassert>
 module vireo.vulkan;
 
 import vireo.tools;
@@ -111,13 +112,45 @@ namespace vireo {
            name);
     }
 
+    std::shared_ptr<Buffer> VKVireo::createBuffer(
+        const BufferType type,
+        const BufferUsage usage,
+        const size_t size,
+        const size_t count,
+        const std::wstring& name) const  {
+        return std::make_shared<VKBuffer>(
+           getVKDevice(), type,
+           size, count,
+           name,
+           false, 1, usage);
+    }
+
+    std::shared_ptr<Buffer> VKVireo::createMappedBuffer(
+        const BufferType type,
+        const size_t size,
+        const size_t count,
+        const uint32_t versionCount,
+        const std::wstring& name) const  {
+        assert(type == BufferType::UNIFORM || type == BufferType::STORAGE);
+        if (versionCount > 1 && type != BufferType::UNIFORM) {
+            // Only the UNIFORM_DYNAMIC descriptors can select the current version with a dynamic offset
+            throw Exception("Only UNIFORM mapped buffers can have more than one version");
+        }
+        return std::make_shared<VKBuffer>(
+           getVKDevice(), type,
+           size, count,
+           name,
+           true, versionCount);
+    }
+
     std::shared_ptr<Image> VKVireo::createImage(
             const ImageFormat format,
             const uint32_t width,
             const uint32_t height,
             const uint32_t mipLevels,
             const uint32_t arraySize,
-            const std::wstring& name) const {
+            const std::wstring& name,
+            const ImageUsage usage) const {
         return std::make_shared<VKImage>(
             getVKDevice(),
             format,
@@ -126,11 +159,12 @@ namespace vireo {
             mipLevels,
             arraySize,
             name,
+            (usage & ImageUsage::STORAGE) == ImageUsage::STORAGE,
             false,
             false,
             false,
-            false,
-            MSAA::NONE);
+            MSAA::NONE,
+            usage);
     }
 
     std::shared_ptr<Image> VKVireo::createReadWriteImage(
@@ -162,7 +196,8 @@ namespace vireo {
             const RenderTargetType type,
             const ClearValue clearValue,
             const MSAA msaa,
-            const std::wstring& name) const {
+            const std::wstring& name,
+            const ImageUsage usage) const {
         return std::make_shared<RenderTarget>(
             type,
             std::make_shared<VKImage>(
@@ -177,14 +212,16 @@ namespace vireo {
                 true,
                 type == RenderTargetType::DEPTH || type == RenderTargetType::DEPTH_STENCIL,
                 type == RenderTargetType::DEPTH_STENCIL,
-                msaa));
+                msaa,
+                usage));
     }
 
     std::shared_ptr<RenderTarget> VKVireo::createRenderTarget(
         const std::shared_ptr<const SwapChain>& swapChain,
         const ClearValue clearValue,
         MSAA msaa,
-        const std::wstring& name) const {
+        const std::wstring& name,
+        const ImageUsage usage) const {
         return std::make_shared<RenderTarget>(
             RenderTargetType::COLOR,
             std::make_shared<VKImage>(
@@ -199,11 +236,243 @@ namespace vireo {
                 true,
                 false,
                 false,
-                msaa));
+                msaa,
+                usage));
+    }
+
+    std::shared_ptr<MemoryHeap> VKVireo::createMemoryHeap(
+        const size_t size,
+        const std::wstring& name,
+        const MemoryHeapUsage usage) const {
+        return std::make_shared<VKMemoryHeap>(getVKDevice(), size, usage, name);
+    }
+
+    std::shared_ptr<Buffer> VKVireo::createPlacedBuffer(
+        const std::shared_ptr<const MemoryHeap>& heap,
+        const size_t offset,
+        const BufferType type,
+        const size_t size,
+        const size_t count,
+        const std::wstring& name) const {
+        assert(heap != nullptr);
+        if (!heap->isUsageAllowed(MemoryHeapUsage::BUFFERS)) {
+            throw Exception("Resource class not allowed in the memory heap");
+        }
+        assert(type == BufferType::VERTEX ||
+               type == BufferType::INDEX ||
+               type == BufferType::INDIRECT ||
+               type == BufferType::DEVICE_STORAGE ||
+               type == BufferType::READWRITE_STORAGE);
+        return std::make_shared<VKBuffer>(
+           getVKDevice(), type,
+           size, count,
+           name,
+           false, 1, BufferUsage::NONE,
+           static_pointer_cast<const VKMemoryHeap>(heap), offset);
+    }
+
+    std::shared_ptr<Image> VKVireo::createPlacedImage(
+        const std::shared_ptr<const MemoryHeap>& heap,
+        const size_t offset,
+        const ImageFormat format,
+        const uint32_t width,
+        const uint32_t height,
+        const uint32_t mipLevels,
+        const uint32_t arraySize,
+        const std::wstring& name,
+        const ImageUsage usage) const {
+        assert(heap != nullptr);
+        if (!heap->isUsageAllowed(MemoryHeapUsage::IMAGES)) {
+            throw Exception("Resource class not allowed in the memory heap");
+        }
+        return std::make_shared<VKImage>(
+            getVKDevice(),
+            format,
+            width,
+            height,
+            mipLevels,
+            arraySize,
+            name,
+            (usage & ImageUsage::STORAGE) == ImageUsage::STORAGE,
+            false,
+            false,
+            false,
+            MSAA::NONE,
+            usage,
+            static_pointer_cast<const VKMemoryHeap>(heap),
+            offset);
+    }
+
+    std::shared_ptr<RenderTarget> VKVireo::createPlacedRenderTarget(
+        const std::shared_ptr<const MemoryHeap>& heap,
+        const size_t offset,
+        const ImageFormat format,
+        const uint32_t width,
+        const uint32_t height,
+        const RenderTargetType type,
+        const ClearValue clearValue,
+        const MSAA msaa,
+        const std::wstring& name,
+        const ImageUsage usage) const {
+        assert(heap != nullptr);
+        if (!heap->isUsageAllowed(MemoryHeapUsage::RENDER_TARGETS)) {
+            throw Exception("Resource class not allowed in the memory heap");
+        }
+        // Lazily allocated memory can't be placed
+        assert((usage & ImageUsage::TRANSIENT) != ImageUsage::TRANSIENT);
+        return std::make_shared<RenderTarget>(
+            type,
+            std::make_shared<VKImage>(
+                getVKDevice(),
+                format,
+                width,
+                height,
+                1,
+                1,
+                name,
+                false,
+                true,
+                type == RenderTargetType::DEPTH || type == RenderTargetType::DEPTH_STENCIL,
+                type == RenderTargetType::DEPTH_STENCIL,
+                msaa,
+                usage,
+                static_pointer_cast<const VKMemoryHeap>(heap),
+                offset));
     }
 
     void VKVireo::waitIdle() {
         vkDeviceWaitIdle(getVKDevice()->getDevice());
+        // Nothing is in use by the GPU anymore
+        getVKDevice()->getDeletionQueue().flush();
+    }
+
+    void VKVireo::setDeferredDestruction(const uint32_t framesInFlight) {
+        getVKDevice()->getDeletionQueue().setDeferredFrames(framesInFlight);
+    }
+
+    void VKVireo::collect() {
+        getVKDevice()->getDeletionQueue().collect();
+    }
+
+    VideoMemoryBudget VKVireo::getMemoryBudget() const {
+        const auto& physicalDevice = *getVKPhysicalDevice();
+        const auto& allocator = getVKDevice()->getMemoryAllocator();
+        const auto& memoryProperties = allocator.getMemoryProperties();
+        const auto budgetSupported = physicalDevice.isDeviceExtensionEnabled(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        auto budgetProperties = VkPhysicalDeviceMemoryBudgetPropertiesEXT {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT,
+        };
+        if (budgetSupported) {
+            auto memoryProperties2 = VkPhysicalDeviceMemoryProperties2 {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2,
+                .pNext = &budgetProperties,
+            };
+            vkGetPhysicalDeviceMemoryProperties2(physicalDevice.getPhysicalDevice(), &memoryProperties2);
+        }
+        auto budget = VideoMemoryBudget {
+            .heapCount = std::min(memoryProperties.memoryHeapCount, VideoMemoryBudget::MAX_HEAPS),
+        };
+        for (uint32_t i = 0; i < budget.heapCount; i++) {
+            const auto& heap = memoryProperties.memoryHeaps[i];
+            const auto allocated = allocator.getHeapAllocatedBytes(i);
+            budget.heaps[i] = {
+                .size = heap.size,
+                .deviceLocal = (heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0,
+                .allocated = allocated,
+                .usage = budgetSupported ? budgetProperties.heapUsage[i] : allocated,
+                .budget = budgetSupported ? budgetProperties.heapBudget[i] : heap.size,
+            };
+        }
+        return budget;
+    }
+
+    VideoMemoryStatistics VKVireo::getMemoryStatistics() const {
+        const auto statistics = getVKDevice()->getMemoryAllocator().getStatistics();
+        return {
+            .blockCount = statistics.blockCount,
+            .dedicatedBlockCount = statistics.dedicatedBlockCount,
+            .allocationCount = statistics.allocationCount,
+            .blockBytes = statistics.blockBytes,
+            .allocatedBytes = statistics.allocatedBytes,
+            .freeRangeCount = statistics.freeRangeCount,
+            .freeBytes = statistics.freeBytes,
+            .largestFreeRange = statistics.largestFreeRange,
+        };
+    }
+
+    bool VKVireo::isHostImageCopySupported() const {
+        return getVKPhysicalDevice()->isHostImageCopySupported();
+    }
+
+    void VKVireo::upload(const Image& destination, const void* source, const uint32_t mipLevel) const {
+        assert(source != nullptr);
+        assert(mipLevel < destination.getMipLevels());
+        if (!isHostImageCopySupported()) {
+            throw Exception("Host image copies not supported");
+        }
+        assert(destination.hasUsage(ImageUsage::HOST_TRANSFER));
+        const auto& image = static_cast<const VKImage&>(destination);
+        const auto vkDevice = getVKDevice()->getDevice();
+        // Only the uploaded level is transitioned, the content of the other levels is kept
+        const auto transition = VkHostImageLayoutTransitionInfoEXT {
+            .sType = VK_STRUCTURE_TYPE_HOST_IMAGE_LAYOUT_TRANSITION_INFO_EXT,
+            .image = image.getImage(),
+            .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+            .newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            .subresourceRange = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .baseMipLevel = mipLevel,
+                .levelCount = 1,
+                .baseArrayLayer = 0,
+                .layerCount = image.getArraySize(),
+            },
+        };
+        vkCheck(vkTransitionImageLayoutEXT(vkDevice, 1, &transition));
+        const auto region = VkMemoryToImageCopyEXT {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_TO_IMAGE_COPY_EXT,
+            .pHostPointer = source,
+            .memoryRowLength = 0,
+            .memoryImageHeight = 0,
+            .imageSubresource = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .mipLevel = mipLevel,
+                .baseArrayLayer = 0,
+                .layerCount = image.getArraySize(),
+            },
+            .imageOffset = {0, 0, 0},
+            .imageExtent = {
+                std::max(1u, image.getWidth() >> mipLevel),
+                std::max(1u, image.getHeight() >> mipLevel),
+                1
+            },
+        };
+        const auto copyInfo = VkCopyMemoryToImageInfoEXT {
+            .sType = VK_STRUCTURE_TYPE_COPY_MEMORY_TO_IMAGE_INFO_EXT,
+            .dstImage = image.getImage(),
+            .dstImageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            .regionCount = 1,
+            .pRegions = &region,
+        };
+        vkCheck(vkCopyMemoryToImageEXT(vkDevice, &copyInfo));
+    }
+
+    size_t VKVireo::getHostImportAlignment() const {
+        return getVKPhysicalDevice()->getMinImportedHostPointerAlignment();
+    }
+
+    std::shared_ptr<Buffer> VKVireo::importHostBuffer(
+        void* address,
+        const size_t size,
+        const BufferType type,
+        const std::wstring& name) const {
+        const auto alignment = getHostImportAlignment();
+        if (alignment == 0) {
+            throw Exception("Host memory import not supported");
+        }
+        if (reinterpret_cast<std::uintptr_t>(address) % alignment != 0 || size == 0 || size % alignment != 0) {
+            throw Exception("Host memory not aligned for import");
+        }
+        return std::make_shared<VKBuffer>(getVKDevice(), type, address, size, name);
     }
 
     std::shared_ptr<DescriptorLayout> VKVireo::createDescriptorLayout(
@@ -22,6 +22,26 @@ export namespace vireo {
 
         void waitIdle() override;
 
+        void setDeferredDestruction(uint32_t framesInFlight) override;
+
+        void collect() override;
+
+        VideoMemoryBudget getMemoryBudget() const override;
+
+        VideoMemoryStatistics getMemoryStatistics() const override;
+
+        bool isHostImageCopySupported() const override;
+
+        void upload(const Image& destination, const void* source, uint32_t mipLevel) const override;
+
+        size_t getHostImportAlignment() const override;
+
+        std::shared_ptr<Buffer> importHostBuffer(
+            void* address,
+            size_t size,
+            BufferType type,
+            const std::wstring& name) const override;
+
         std::shared_ptr<SwapChain> createSwapChain(
             ImageFormat format,
             const std::shared_ptr<const SubmitQueue>& submitQueue,
@@ -77,13 +97,28 @@ export namespace vireo {
             size_t count,
             const std::wstring& name) const override;
 
+        std::shared_ptr<Buffer> createBuffer(
+            BufferType type,
+            BufferUsage usage,
+            size_t size,
+            size_t count,
+            const std::wstring& name) const override;
+
+        std::shared_ptr<Buffer> createMappedBuffer(
+            BufferType type,
+            size_t size,
+            size_t count,
+            uint32_t versionCount,
+            const std::wstring& name) const override;
+
         std::shared_ptr<Image> createImage(
             ImageFormat format,
             uint32_t width,
             uint32_t height,
             uint32_t mipLevels,
             uint32_t arraySize,
-            const std::wstring& name) const override;
+            const std::wstring& name,
+            ImageUsage usage) const override;
 
         std::shared_ptr<Image> createReadWriteImage(
             ImageFormat format,
@@ -100,14 +135,52 @@ export namespace vireo {
             RenderTargetType type,
             ClearValue clearValue,
             MSAA msaa,
-            const std::wstring& name) const override;
+            const std::wstring& name,
+            ImageUsage usage) const override;
 
         std::shared_ptr<RenderTarget> createRenderTarget(
             const std::shared_ptr<const SwapChain>& swapChain,
             ClearValue clearValue,
             MSAA msaa,
+            const std::wstring& name,
+            ImageUsage usage) const override;
+
+        std::shared_ptr<MemoryHeap> createMemoryHeap(
+            size_t size,
+            const std::wstring& name,
+            MemoryHeapUsage usage) const override;
+
+        std::shared_ptr<Buffer> createPlacedBuffer(
+            const std::shared_ptr<const MemoryHeap>& heap,
+            size_t offset,
+            BufferType type,
+            size_t size,
+            size_t count,
             const std::wstring& name) const override;
 
+        std::shared_ptr<Image> createPlacedImage(
+            const std::shared_ptr<const MemoryHeap>& heap,
+            size_t offset,
+            ImageFormat format,
+            uint32_t width,
+            uint32_t height,
+            uint32_t mipLevels,
+            uint32_t arraySize,
+            const std::wstring& name,
+            ImageUsage usage) const override;
+
+        std::shared_ptr<RenderTarget> createPlacedRenderTarget(
+            const std::shared_ptr<const MemoryHeap>& heap,
+            size_t offset,
+            ImageFormat format,
+            uint32_t width,
+            uint32_t height,
+            RenderTargetType type,
+            ClearValue clearValue,
+            MSAA msaa,
+            const std::wstring& name,
+            ImageUsage usage) const override;
+
         std::shared_ptr<DescriptorLayout> createDescriptorLayout(
             const std::wstring& name) const override;
 